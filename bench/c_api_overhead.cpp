@@ -0,0 +1,54 @@
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "bench_fens.hpp"
+#include "chessatron.h"
+#include "uci_engine.hpp"
+
+// The same searches made in-process through the C API and over UCI through a pipe to a child process, so that the difference is the
+// cost of the process boundary and the text protocol.  At depth 1 that is almost the whole cost of a call
+
+void BM_CApiSearch(benchmark::State& state) {
+    auto engine = chessatron_new(16);
+    const chessatron_limits limits = {0, 0, static_cast<int>(state.range(0))};
+    size_t fen_index = 0;
+    for (auto _ : state) {
+        chessatron_set_fen(engine, bench_fens[fen_index++ % bench_fens.size()]);
+        chessatron_result result;
+        chessatron_search(engine, &limits, nullptr, nullptr, &result);
+        benchmark::DoNotOptimize(result);
+    }
+    chessatron_free(engine);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CApiSearch)->Arg(1)->Arg(4)->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+void BM_UciSearch(benchmark::State& state) {
+    UciEngine engine(CHESSATRON_BINARY);
+    engine.send("uci");
+    engine.wait_for("uciok", 10000);
+    const auto go = "go depth " + std::to_string(state.range(0));
+    size_t fen_index = 0;
+    for (auto _ : state) {
+        engine.send(std::string("position fen ") + bench_fens[fen_index++ % bench_fens.size()]);
+        engine.send(go);
+        benchmark::DoNotOptimize(engine.wait_for("bestmove", 10000));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+// the engine runs in another process, so only the wall time means anything
+BENCHMARK(BM_UciSearch)->Arg(1)->Arg(4)->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+void BM_CApiLegalMoves(benchmark::State& state) {
+    auto engine = chessatron_new(1);
+    chessatron_move moves[256];
+    size_t fen_index = 0;
+    for (auto _ : state) {
+        chessatron_set_fen(engine, bench_fens[fen_index++ % bench_fens.size()]);
+        benchmark::DoNotOptimize(chessatron_legal_moves(engine, moves, 256));
+    }
+    chessatron_free(engine);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CApiLegalMoves);
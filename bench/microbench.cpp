@@ -0,0 +1,237 @@
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "bench_fens.hpp"
+#include "chessboard.hpp"
+#include "evaluation.hpp"
+#include "move_generator.hpp"
+#include "move_ordering.hpp"
+#include "search.hpp"
+#include "ttable.hpp"
+
+/**
+ * @brief The bench positions, which every microbenchmark runs over so that results stay comparable between runs and with bench
+ */
+const std::vector<Position>& corpus() {
+    static const auto positions = [] {
+        std::vector<Position> to_return(bench_fens.size());
+        for (size_t i = 0; i < bench_fens.size(); i++) {
+            to_return[i].set_from_fen(bench_fens[i]);
+        }
+        return to_return;
+    }();
+    return positions;
+}
+
+/**
+ * @brief The corpus and every position one legal move from it, so that consecutive positions are related as they are in search
+ */
+const std::vector<Position>& corpus_with_children() {
+    static const auto positions = [] {
+        std::vector<Position> to_return;
+        for (const auto& pos : corpus()) {
+            to_return.push_back(pos);
+            const auto moves = MoveGenerator::generate_legal_moves<MoveGenType::ALL_LEGAL>(pos, pos.stm());
+            for (size_t i = 0; i < moves.size(); i++) {
+                to_return.emplace_back(pos, moves[i].move);
+            }
+        }
+        return to_return;
+    }();
+    return positions;
+}
+
+template <MoveGenType gen_type> void BM_GenerateLegalMoves(benchmark::State& state) {
+    uint64_t move_count = 0;
+    for (auto _ : state) {
+        for (const auto& pos : corpus()) {
+            const auto moves = MoveGenerator::generate_legal_moves<gen_type>(pos, pos.stm());
+            benchmark::DoNotOptimize(moves);
+            move_count += moves.size();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * corpus().size());
+    state.counters["moves"] = benchmark::Counter(move_count, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_GenerateLegalMoves<MoveGenType::ALL_LEGAL>);
+BENCHMARK(BM_GenerateLegalMoves<MoveGenType::QUIESCENCE>);
+
+void BM_HasLegalMove(benchmark::State& state) {
+    for (auto _ : state) {
+        for (const auto& pos : corpus()) {
+            benchmark::DoNotOptimize(MoveGenerator::has_legal_move(pos));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * corpus().size());
+}
+BENCHMARK(BM_HasLegalMove);
+
+void BM_MakeMove(benchmark::State& state) {
+    std::vector<std::pair<const Position*, Move>> moves;
+    for (const auto& pos : corpus()) {
+        const auto legal_moves = MoveGenerator::generate_legal_moves<MoveGenType::ALL_LEGAL>(pos, pos.stm());
+        for (size_t i = 0; i < legal_moves.size(); i++) {
+            moves.emplace_back(&pos, legal_moves[i].move);
+        }
+    }
+    for (auto _ : state) {
+        for (const auto& [pos, move] : moves) {
+            const Position child(*pos, move);
+            benchmark::DoNotOptimize(child);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * moves.size());
+}
+BENCHMARK(BM_MakeMove);
+
+/**
+ * @brief Every noisy move in the corpus, which is what search runs static exchange evaluation on
+ */
+const std::vector<std::pair<const Position*, Move>>& corpus_captures() {
+    static const auto captures = [] {
+        std::vector<std::pair<const Position*, Move>> to_return;
+        for (const auto& pos : corpus()) {
+            const auto noisy_moves = MoveGenerator::generate_legal_moves<MoveGenType::QUIESCENCE>(pos, pos.stm());
+            for (size_t i = 0; i < noisy_moves.size(); i++) {
+                to_return.emplace_back(&pos, noisy_moves[i].move);
+            }
+        }
+        return to_return;
+    }();
+    return captures;
+}
+
+void BM_StaticExchangeEvaluation(benchmark::State& state) {
+    for (auto _ : state) {
+        for (const auto& [pos, move] : corpus_captures()) {
+            benchmark::DoNotOptimize(Search::static_exchange_evaluation(*pos, move, 0));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * corpus_captures().size());
+}
+BENCHMARK(BM_StaticExchangeEvaluation);
+
+void BM_StaticExchangeValue(benchmark::State& state) {
+    for (auto _ : state) {
+        for (const auto& [pos, move] : corpus_captures()) {
+            benchmark::DoNotOptimize(Search::static_exchange_value(*pos, move));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * corpus_captures().size());
+}
+BENCHMARK(BM_StaticExchangeValue);
+
+void BM_EvaluateBoard(benchmark::State& state) {
+    const auto& positions = corpus_with_children();
+    for (auto _ : state) {
+        for (const auto& pos : positions) {
+            benchmark::DoNotOptimize(Evaluation::evaluate_board(pos));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * positions.size());
+}
+BENCHMARK(BM_EvaluateBoard);
+
+void BM_EvaluateBoardWithPawnTable(benchmark::State& state) {
+    const auto& positions = corpus_with_children();
+    PawnTable pawn_table;
+    for (auto _ : state) {
+        for (const auto& pos : positions) {
+            benchmark::DoNotOptimize(Evaluation::evaluate_board(pos, pawn_table));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * positions.size());
+}
+BENCHMARK(BM_EvaluateBoardWithPawnTable);
+
+void BM_TranspositionTableStore(benchmark::State& state) {
+    const auto& positions = corpus_with_children();
+    TranspositionTable table;
+    for (auto _ : state) {
+        for (const auto& pos : positions) {
+            table.store(TranspositionTableEntry(Move::NULL_MOVE(), 8, BoundTypes::LOWER_BOUND, 0, 0, pos.zobrist_key()), pos);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * positions.size());
+}
+BENCHMARK(BM_TranspositionTableStore);
+
+void BM_TranspositionTableProbe(benchmark::State& state) {
+    const auto& positions = corpus_with_children();
+    TranspositionTable table;
+    // only every other position is stored, so that both hits and misses are measured
+    for (size_t i = 0; i < positions.size(); i += 2) {
+        table.store(TranspositionTableEntry(Move::NULL_MOVE(), 8, BoundTypes::EXACT_BOUND, 0, 0, positions[i].zobrist_key()), positions[i]);
+    }
+    for (auto _ : state) {
+        for (const auto& pos : positions) {
+            benchmark::DoNotOptimize(table.probe(pos));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * positions.size());
+}
+BENCHMARK(BM_TranspositionTableProbe);
+
+void BM_MovePickerNext(benchmark::State& state) {
+    HistoryTable history_table;
+    const SearchStackFrame parent;
+    uint64_t move_count = 0;
+    for (auto _ : state) {
+        for (const auto& pos : corpus()) {
+            MovePicker picker(MoveGenerator::generate_legal_moves<MoveGenType::ALL_LEGAL>(pos, pos.stm()), pos, parent, Move::NULL_MOVE(),
+                              history_table, Move::NULL_MOVE());
+            while (const auto move = picker.next(false)) {
+                benchmark::DoNotOptimize(move);
+                move_count += 1;
+            }
+        }
+    }
+    state.SetItemsProcessed(move_count);
+}
+BENCHMARK(BM_MovePickerNext);
+
+/**
+ * @brief A game with a long run of reversible moves and no repetitions, so that every check scans as far back as the halfmove clock
+ * allows, which is the worst case for the search
+ */
+BoardHistory reversible_history() {
+    Position start;
+    start.set_from_fen("r3k3/8/8/8/8/8/8/R3K3 w - - 0 1");
+    std::mt19937_64 rng(0);
+    while (true) {
+        BoardHistory history(start);
+        // a random walk can run into a dead end where every move repeats, in which case it starts again
+        for (int attempts = 0; attempts < 1000 && history[history.len() - 1].get_halfmove_clock() < 99; attempts++) {
+            const auto& pos = history[history.len() - 1];
+            const auto moves = MoveGenerator::generate_legal_moves<MoveGenType::ALL_LEGAL>(pos, pos.stm());
+            if (moves.size() == 0) {
+                break;
+            }
+            const auto move = moves[rng() % moves.size()].move;
+            const Position child(pos, move);
+            bool repeats = move.is_noisy();
+            for (size_t i = 0; i < history.len(); i++) {
+                repeats |= history[i].zobrist_key() == child.zobrist_key();
+            }
+            if (!repeats) {
+                history.push_board(child, move);
+            }
+        }
+        if (history[history.len() - 1].get_halfmove_clock() >= 99) {
+            return history;
+        }
+    }
+}
+
+void BM_IsThreefoldRepetition(benchmark::State& state) {
+    const auto history = reversible_history();
+    const auto& pos = history[history.len() - 1];
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Search::is_threefold_repetition(history, pos.get_halfmove_clock(), pos.zobrist_key()));
+    }
+}
+BENCHMARK(BM_IsThreefoldRepetition);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,251 @@
+#include "analyze.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#include "search.hpp"
+#include "uci.hpp"
+
+/**
+ * @brief Parses the options following the EPD file, or returns nothing if there's an option it doesn't know or a value that isn't a
+ * positive number
+ */
+std::optional<Analyze::Settings> Analyze::parse_args(const std::vector<std::string>& args) {
+    Settings settings;
+    settings.threads = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+    for (size_t i = 0; i < args.size(); i++) {
+        if (args[i] == "--shared-tt") {
+            settings.shared_tt = true;
+            continue;
+        }
+        if (i + 1 == args.size()) {
+            return std::nullopt;
+        }
+        const auto& arg = args[i];
+        const auto value = parse_number<uint64_t>(args[++i]);
+        if (!value.has_value() || *value == 0) {
+            return std::nullopt;
+        }
+        if (arg == "--depth" && *value <= MAX_PLY - PLY_OFFSET) {
+            settings.limits = DepthTC{static_cast<uint16_t>(*value)};
+        } else if (arg == "--nodes") {
+            settings.limits = NodeTC{*value, *value};
+        } else if (arg == "--movetime" && *value <= UINT32_MAX) {
+            settings.limits = FixedTimeTC{static_cast<uint32_t>(*value)};
+        } else if (arg == "--threads" && *value <= 1024) {
+            settings.threads = static_cast<int>(*value);
+        } else if (arg == "--hash") {
+            settings.hash_mb = *value;
+        } else {
+            return std::nullopt;
+        }
+    }
+    return settings;
+}
+
+/**
+ * @brief Parses an EPD line, or a FEN line with the move counters, taking the id from the operations if there is one
+ */
+std::optional<Analyze::Job> Analyze::parse_epd_line(const std::string& line) {
+    std::istringstream fields(line);
+    std::string fen, field;
+    for (int i = 0; i < 4; i++) {
+        if (!(fields >> field)) {
+            return std::nullopt;
+        }
+        fen += field + " ";
+    }
+    // a FEN has the move counters next, where an EPD has its operations
+    const auto is_number = [](const std::string& s) { return !s.empty() && std::all_of(s.begin(), s.end(), ::isdigit); };
+    auto rest_start = fields.tellg();
+    std::string halfmove, fullmove;
+    if (fields >> halfmove >> fullmove && is_number(halfmove) && is_number(fullmove)) {
+        fen += halfmove + " " + fullmove;
+        rest_start = fields.tellg();
+    } else {
+        fen += "0 1";
+    }
+    Position pos;
+    if (!pos.set_from_fen(fen).has_value()) {
+        return std::nullopt;
+    }
+
+    Job job{fen, ""};
+    std::istringstream operations((rest_start == std::istringstream::pos_type(-1)) ? "" : line.substr(rest_start));
+    for (std::string operation; std::getline(operations, operation, ';');) {
+        std::istringstream tokens(operation);
+        std::string opcode;
+        if (tokens >> opcode && opcode == "id") {
+            std::getline(tokens >> std::ws, job.id);
+            job.id.erase(std::remove(job.id.begin(), job.id.end(), '"'), job.id.end());
+        }
+    }
+    return job;
+}
+
+std::vector<Analyze::Job> Analyze::load_epd(const std::string& path) {
+    std::vector<Job> jobs;
+    std::ifstream file(path);
+    for (std::string line; std::getline(file, line);) {
+        const auto job = parse_epd_line(line);
+        if (job.has_value()) {
+            jobs.push_back(*job);
+        }
+    }
+    return jobs;
+}
+
+namespace {
+
+/**
+ * @brief One searcher's share of the positions.  The owner takes from the front and thieves from the back, so that the two only
+ * contend for the lock when the queue is nearly empty
+ */
+struct AnalyzeQueue {
+    std::deque<size_t> jobs;
+    std::mutex mutex;
+};
+
+struct AnalyzeState {
+    std::vector<Analyze::Job> jobs;
+    std::vector<AnalyzeQueue> queues;
+    // results are printed in input order, so each one waits here until every result before it has been printed
+    std::vector<std::string> results;
+    std::vector<bool> finished;
+    size_t next_to_print = 0;
+    std::mutex output_mutex;
+    std::atomic<uint64_t> nodes = 0;
+    std::atomic<uint64_t> steals = 0;
+};
+
+std::optional<size_t> next_analyze_job(AnalyzeState& state, size_t worker) {
+    {
+        auto& own = state.queues[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty()) {
+            const auto job = own.jobs.front();
+            own.jobs.pop_front();
+            return job;
+        }
+    }
+    for (size_t i = 1; i < state.queues.size(); i++) {
+        auto& victim = state.queues[(worker + i) % state.queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty()) {
+            const auto job = victim.jobs.back();
+            victim.jobs.pop_back();
+            state.steals += 1;
+            return job;
+        }
+    }
+    return std::nullopt;
+}
+
+std::string json_escape(const std::string& s) {
+    std::string escaped;
+    for (const auto c : s) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+std::string analyze_result_json(size_t index, const Analyze::Job& job, Move move, Score score, const SearchHandler& handler, int64_t time_ms) {
+    std::string json = "{\"index\": " + std::to_string(index);
+    if (!job.id.empty()) {
+        json += ", \"id\": \"" + json_escape(job.id) + "\"";
+    }
+    json += ", \"fen\": \"" + job.fen + "\", \"bestmove\": \"" + move.to_string() + "\"";
+    if (const auto mate = Search::moves_to_mate(score); mate != 0) {
+        json += ", \"mate\": " + std::to_string(mate);
+    } else {
+        json += ", \"cp\": " + std::to_string(score);
+    }
+    json += ", \"depth\": " + std::to_string(handler.get_completed_depth()) + ", \"nodes\": " + std::to_string(handler.get_node_count())
+            + ", \"time_ms\": " + std::to_string(time_ms) + ", \"pv\": [";
+    auto pv = handler.get_pv();
+    if (pv.empty() || pv[0] != move) {
+        // a position with one legal move isn't searched, so there's no pv for it
+        pv = {move};
+    }
+    for (size_t i = 0; i < pv.size(); i++) {
+        json += std::string(i == 0 ? "" : ", ") + "\"" + pv[i].to_string() + "\"";
+    }
+    return json + "]}";
+}
+
+void run_analyze_worker(AnalyzeState& state, size_t worker, TranspositionTable& table, const Analyze::Settings& settings) {
+    SearchHandler handler(table);
+    handler.set_print_info(false);
+    while (const auto index = next_analyze_job(state, worker)) {
+        const auto& job = state.jobs[*index];
+        if (!settings.shared_tt) {
+            // with a table of its own, clearing everything makes each result independent of which positions this searcher had before
+            handler.reset();
+        }
+        Position pos;
+        pos.set_from_fen(job.fen);
+        handler.set_pos(pos);
+        const auto start = std::chrono::steady_clock::now();
+        const auto [move, score] = handler.search_sync(settings.limits);
+        const auto time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        state.nodes += handler.get_node_count();
+
+        std::lock_guard<std::mutex> lock(state.output_mutex);
+        state.results[*index] = analyze_result_json(*index, job, move, score, handler, time_ms);
+        state.finished[*index] = true;
+        for (; state.next_to_print < state.jobs.size() && state.finished[state.next_to_print]; state.next_to_print++) {
+            printf("%s\n", state.results[state.next_to_print].c_str());
+            state.results[state.next_to_print].clear();
+        }
+        fflush(stdout);
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Analyses every position of an EPD file with independent searchers, one per thread, printing one JSON line per position in
+ * the order of the file.  Each searcher starts with a contiguous share of the positions and steals from the others once its own run
+ * out, so that a few slow positions don't leave the other threads idle at the end
+ */
+void Analyze::run_analyze(const std::string& epd_path, const Settings& settings) {
+    AnalyzeState state;
+    state.jobs = load_epd(epd_path);
+    const auto threads = static_cast<size_t>(std::max(settings.threads, 1));
+    state.queues = std::vector<AnalyzeQueue>(threads);
+    for (size_t i = 0; i < state.jobs.size(); i++) {
+        state.queues[i * threads / state.jobs.size()].jobs.push_back(i);
+    }
+    state.results.resize(state.jobs.size());
+    state.finished.resize(state.jobs.size(), false);
+
+    std::vector<std::unique_ptr<TranspositionTable>> tables;
+    for (size_t i = 0; i < (settings.shared_tt ? 1 : threads); i++) {
+        tables.push_back(std::make_unique<TranspositionTable>());
+        tables.back()->resize(std::max(settings.shared_tt ? settings.hash_mb : settings.hash_mb / threads, (size_t) 1));
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < threads; i++) {
+        workers.emplace_back(run_analyze_worker, std::ref(state), i, std::ref(*tables[settings.shared_tt ? 0 : i]), std::cref(settings));
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    // the summary goes to stderr so that stdout stays valid JSON lines
+    const auto elapsed = std::max(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), 0.001);
+    fprintf(stderr, "analysed %zu positions in %.1fs on %zu threads, %.1f positions/s, %lu nps, %lu steals\n", state.jobs.size(), elapsed,
+            threads, state.jobs.size() / elapsed, static_cast<uint64_t>(state.nodes / elapsed), state.steals.load());
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "time_management.hpp"
+
+namespace Analyze {
+    /**
+     * @brief A position to analyse, with the EPD id operation if it had one
+     */
+    struct Job {
+        std::string fen;
+        std::string id;
+    };
+
+    struct Settings {
+        TimeControlInfo limits = DepthTC{12};
+        int threads = 1;
+        size_t hash_mb = 64;
+        // whether every searcher probes one table of hash_mb, or each has hash_mb / threads of its own
+        bool shared_tt = false;
+    };
+
+    std::optional<Settings> parse_args(const std::vector<std::string>& args);
+    std::optional<Job> parse_epd_line(const std::string& line);
+    std::vector<Job> load_epd(const std::string& path);
+
+    void run_analyze(const std::string& epd_path, const Settings& settings);
+} // namespace Analyze
@@ -0,0 +1,82 @@
+#ifndef CHESSATRON_H
+#define CHESSATRON_H
+
+/*
+ * The C interface to libchessatron, for embedding the engine in-process rather than talking UCI to it over a pipe.  Every function
+ * taking an engine may be called from any thread, but not from two threads at once for the same engine; the one exception is
+ * chessatron_stop, which may be called while an asynchronous search is running.  Moves are given and returned in UCI notation.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* libchessatron is built with hidden visibility, so these functions are the only symbols the shared library exports. */
+#if defined(__GNUC__)
+#define CHESSATRON_API __attribute__((visibility("default")))
+#else
+#define CHESSATRON_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct chessatron_engine chessatron_engine;
+
+/* A UCI move, such as "e2e4" or "e7e8q", with its terminating null. */
+typedef char chessatron_move[6];
+
+/* Only the first non-zero limit, in the order below, applies; with every limit at zero the search runs until it's stopped. */
+typedef struct {
+    uint64_t nodes;
+    uint32_t movetime_ms;
+    int depth;
+} chessatron_limits;
+
+typedef struct {
+    chessatron_move bestmove;
+    /* the score from the side to move's perspective, in centipawns unless mate is non-zero */
+    int score_cp;
+    /* moves until mate, negative if the side to move is being mated, or zero if no mate was found */
+    int mate;
+    int depth;
+    uint64_t nodes;
+} chessatron_result;
+
+/* Called with each info line the search prints, without its newline. */
+typedef void (*chessatron_info_callback)(const char* line, void* user_data);
+/* Called once an asynchronous search has finished, from the thread that ran it. */
+typedef void (*chessatron_done_callback)(const chessatron_result* result, void* user_data);
+
+/* Creates an engine at the starting position with a transposition table of its own, or returns null if it couldn't be created. */
+CHESSATRON_API chessatron_engine* chessatron_new(size_t hash_mb);
+/* Stops any search in progress and frees the engine. */
+CHESSATRON_API void chessatron_free(chessatron_engine* engine);
+
+/* Returns 0 on success, or -1 if the FEN couldn't be parsed, in which case the position is unchanged. */
+CHESSATRON_API int chessatron_set_fen(chessatron_engine* engine, const char* fen);
+/* Plays a move from the current position.  Returns 0 on success, or -1 if the move isn't legal. */
+CHESSATRON_API int chessatron_make_move(chessatron_engine* engine, const char* move);
+/* Writes up to capacity legal moves to moves, returning the total number of legal moves. */
+CHESSATRON_API int chessatron_legal_moves(chessatron_engine* engine, chessatron_move* moves, int capacity);
+CHESSATRON_API uint64_t chessatron_perft(chessatron_engine* engine, int depth);
+/* The static evaluation of the current position from the side to move's perspective. */
+CHESSATRON_API int chessatron_evaluate(chessatron_engine* engine);
+
+/* Searches the current position on the calling thread.  info may be null.  Returns 0 on success, or -1 if a search is running. */
+CHESSATRON_API int chessatron_search(chessatron_engine* engine, const chessatron_limits* limits, chessatron_info_callback info, void* user_data,
+                      chessatron_result* result);
+/* Starts a search on a thread of its own and returns immediately.  Either callback may be null.  Returns 0 on success, or -1 if a
+ * search is already running. */
+CHESSATRON_API int chessatron_search_async(chessatron_engine* engine, const chessatron_limits* limits, chessatron_info_callback info,
+                            chessatron_done_callback done, void* user_data);
+/* Stops an asynchronous search, returning once its done callback has been called.  Does nothing if no search is running. */
+CHESSATRON_API void chessatron_stop(chessatron_engine* engine);
+/* Waits for an asynchronous search to finish by itself. */
+CHESSATRON_API void chessatron_wait(chessatron_engine* engine);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,187 @@
+#include "chessatron.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#include "evaluation.hpp"
+#include "move_generator.hpp"
+#include "search.hpp"
+
+struct chessatron_engine {
+    TranspositionTable table;
+    SearchHandler handler;
+    std::thread search_thread;
+    std::atomic<bool> searching = false;
+
+    chessatron_engine(size_t hash_mb) : handler(table) {
+        table.resize(std::max(hash_mb, (size_t) 1));
+        handler.set_print_info(false);
+    }
+};
+
+namespace {
+
+TimeControlInfo to_time_control(const chessatron_limits* limits) {
+    if (limits == nullptr) {
+        return InfiniteTC{};
+    } else if (limits->nodes != 0) {
+        return NodeTC{limits->nodes, limits->nodes};
+    } else if (limits->movetime_ms != 0) {
+        return FixedTimeTC{limits->movetime_ms};
+    } else if (limits->depth > 0) {
+        return DepthTC{static_cast<uint16_t>(std::min(limits->depth, MAX_PLY - PLY_OFFSET))};
+    }
+    return InfiniteTC{};
+}
+
+void copy_move(chessatron_move& destination, Move move) {
+    const auto move_string = move.to_string();
+    std::strncpy(destination, move_string.c_str(), sizeof(chessatron_move) - 1);
+    destination[sizeof(chessatron_move) - 1] = '\0';
+}
+
+/**
+ * @brief Runs a search on the calling thread with the engine already marked as searching
+ */
+chessatron_result run_search(chessatron_engine* engine, const TimeControlInfo& tc, chessatron_info_callback info, void* user_data) {
+    auto& handler = engine->handler;
+    handler.set_print_info(info != nullptr);
+    handler.set_info_callback([info, user_data](const std::string& line) { info(line.c_str(), user_data); });
+    const auto [move, score] = handler.search_sync(tc);
+    handler.set_print_info(false);
+    handler.set_info_callback(nullptr);
+
+    chessatron_result result = {};
+    copy_move(result.bestmove, move);
+    result.mate = Search::moves_to_mate(score);
+    result.score_cp = (result.mate == 0) ? score : 0;
+    result.depth = handler.get_completed_depth();
+    result.nodes = handler.get_node_count();
+    return result;
+}
+
+/**
+ * @brief Marks the engine as searching, first joining the thread of an asynchronous search that has already finished
+ */
+bool claim_engine(chessatron_engine* engine) {
+    if (engine->searching.exchange(true)) {
+        return false;
+    }
+    if (engine->search_thread.joinable()) {
+        engine->search_thread.join();
+    }
+    return true;
+}
+
+} // namespace
+
+extern "C" {
+
+chessatron_engine* chessatron_new(size_t hash_mb) {
+    try {
+        auto engine = new chessatron_engine(hash_mb);
+        Position pos;
+        pos.set_from_fen("startpos");
+        engine->handler.set_pos(pos);
+        return engine;
+    } catch (const std::exception&) {
+        return nullptr;
+    }
+}
+
+void chessatron_free(chessatron_engine* engine) {
+    if (engine == nullptr) {
+        return;
+    }
+    chessatron_stop(engine);
+    delete engine;
+}
+
+int chessatron_set_fen(chessatron_engine* engine, const char* fen) {
+    Position pos;
+    if (fen == nullptr || !pos.set_from_fen(fen).has_value()) {
+        return -1;
+    }
+    engine->handler.set_pos(pos);
+    return 0;
+}
+
+int chessatron_make_move(chessatron_engine* engine, const char* move) {
+    auto& pos = engine->handler.get_pos();
+    const auto moves = MoveGenerator::generate_legal_moves<MoveGenType::ALL_LEGAL>(pos, pos.stm());
+    for (size_t i = 0; i < moves.size(); i++) {
+        if (move != nullptr && moves[i].move.to_string() == move) {
+            pos.make_move(moves[i].move, engine->handler.get_history());
+            return 0;
+        }
+    }
+    return -1;
+}
+
+int chessatron_legal_moves(chessatron_engine* engine, chessatron_move* moves, int capacity) {
+    const auto& pos = engine->handler.get_pos();
+    const auto legal_moves = MoveGenerator::generate_legal_moves<MoveGenType::ALL_LEGAL>(pos, pos.stm());
+    for (int i = 0; i < std::min(static_cast<int>(legal_moves.size()), capacity); i++) {
+        copy_move(moves[i], legal_moves[i].move);
+    }
+    return legal_moves.size();
+}
+
+uint64_t chessatron_perft(chessatron_engine* engine, int depth) {
+    if (depth <= 0) {
+        return 1;
+    }
+    Position pos = engine->handler.get_pos();
+    return Perft::run_perft(pos, depth, false);
+}
+
+int chessatron_evaluate(chessatron_engine* engine) { return Evaluation::evaluate_board(engine->handler.get_pos()); }
+
+int chessatron_search(chessatron_engine* engine, const chessatron_limits* limits, chessatron_info_callback info, void* user_data,
+                      chessatron_result* result) {
+    if (!claim_engine(engine)) {
+        return -1;
+    }
+    const auto search_result = run_search(engine, to_time_control(limits), info, user_data);
+    if (result != nullptr) {
+        *result = search_result;
+    }
+    engine->searching = false;
+    return 0;
+}
+
+int chessatron_search_async(chessatron_engine* engine, const chessatron_limits* limits, chessatron_info_callback info,
+                            chessatron_done_callback done, void* user_data) {
+    if (!claim_engine(engine)) {
+        return -1;
+    }
+    engine->search_thread = std::thread([engine, tc = to_time_control(limits), info, done, user_data]() {
+        const auto result = run_search(engine, tc, info, user_data);
+        if (done != nullptr) {
+            done(&result, user_data);
+        }
+        engine->searching = false;
+    });
+    return 0;
+}
+
+void chessatron_stop(chessatron_engine* engine) {
+    // a search that hasn't reached the point of clearing the stop flag yet would miss a single stop, so keep stopping it until it's
+    // finished
+    while (engine->searching) {
+        engine->handler.EndSearch();
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    chessatron_wait(engine);
+}
+
+void chessatron_wait(chessatron_engine* engine) {
+    if (engine->search_thread.joinable()) {
+        engine->search_thread.join();
+    }
+}
+
+} // extern "C"
@@ -1,6 +1,7 @@
 #include "chessboard.hpp"
 
 #include <bit>
+#include <charconv>
 #include <cstring>
 #include <string>
 
@@ -165,6 +166,10 @@ std::optional<int> Position::set_from_fen(const std::string input) {
             default:
                 return std::optional<int>();
             }
+            if (file >= 8) {
+                // a ninth square on the rank would be written to the next rank, or past the board on the last
+                return std::optional<int>();
+            }
             Piece piece = Piece(piece_side, piece_value);
             set_piece(piece, get_position(rank, file));
             // zobrist_key ^= ZobristKeys::PositionKeys[(piece * 64) + get_position(rank, file)];
@@ -239,7 +244,9 @@ std::optional<int> Position::set_from_fen(const std::string input) {
         halfmove_string.push_back(input[char_idx]);
         char_idx += 1;
     }
-    halfmove_clock = std::stoi(halfmove_string);
+    if (std::from_chars(halfmove_string.data(), halfmove_string.data() + halfmove_string.size(), halfmove_clock).ec != std::errc()) {
+        return std::optional<int>();
+    }
     char_idx += 1;
 
     RETURN_NONE_IF_PAST_END;
@@ -249,7 +256,9 @@ std::optional<int> Position::set_from_fen(const std::string input) {
         fullmove_string.push_back(input[char_idx]);
         char_idx += 1;
     }
-    fullmove_counter = std::stoi(fullmove_string);
+    if (std::from_chars(fullmove_string.data(), fullmove_string.data() + fullmove_string.size(), fullmove_counter).ec != std::errc()) {
+        return std::optional<int>();
+    }
 
     return std::optional<int>(char_idx);
 }
@@ -11,7 +11,7 @@
 #include "utils.hpp"
 #include "zobrist_hashing.hpp"
 
-template <PieceTypes p> uint8_t bb_idx = static_cast<int>(p) - 1;
+template <PieceTypes p> constexpr uint8_t bb_idx = static_cast<int>(p) - 1;
 
 class BoardHistory;
 
@@ -0,0 +1,197 @@
+#include "datagen.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "move_generator.hpp"
+#include "search.hpp"
+
+constexpr int datagen_random_plies = 8;
+constexpr int datagen_max_plies = 400;
+// games are adjudicated once either side is this far ahead, as the result is no longer in doubt
+constexpr int datagen_win_adjudication = 2000;
+
+Datagen::PackedPosition Datagen::pack_position(const Position& pos, Score white_score, uint8_t result) {
+    PackedPosition packed = {};
+    packed.occupancy = pos.occupancy().bb;
+    auto occupied = pos.occupancy();
+    for (int i = 0; !occupied.empty(); i++) {
+        packed.pieces[i / 2] |= pos.piece_at(occupied.pop_lsb()).get_value() << (4 * (i % 2));
+    }
+    packed.score = white_score;
+    packed.fullmove_counter = pos.get_fullmove_counter();
+    packed.result = result;
+    packed.stm_en_passant = (static_cast<uint8_t>(pos.stm()) << 7) | pos.get_en_passant_file();
+    packed.castling = pos.get_castling();
+    packed.halfmove_clock = std::min(pos.get_halfmove_clock(), 255);
+    return packed;
+}
+
+std::string Datagen::unpack_to_fen(const PackedPosition& packed) {
+    constexpr std::array<char, 7> piece_chars = {' ', 'p', 'n', 'b', 'r', 'q', 'k'};
+    std::array<Piece, 64> board = {};
+    auto occupied = Bitboard(packed.occupancy);
+    for (int i = 0; !occupied.empty(); i++) {
+        board[sq_to_int(occupied.pop_lsb())] = Piece((packed.pieces[i / 2] >> (4 * (i % 2))) & 0xF);
+    }
+
+    std::string fen;
+    for (int rnk = 7; rnk >= 0; rnk--) {
+        int empty_squares = 0;
+        for (int fle = 0; fle < 8; fle++) {
+            const auto piece = board[rnk * 8 + fle];
+            if (piece.get_value() == 0) {
+                empty_squares += 1;
+                continue;
+            }
+            if (empty_squares != 0) {
+                fen += std::to_string(empty_squares);
+                empty_squares = 0;
+            }
+            const auto c = piece_chars[static_cast<int>(piece.type())];
+            fen += (piece.side() == Side::WHITE) ? static_cast<char>(std::toupper(c)) : c;
+        }
+        if (empty_squares != 0) {
+            fen += std::to_string(empty_squares);
+        }
+        if (rnk != 0) {
+            fen += '/';
+        }
+    }
+
+    const auto stm = Side(packed.stm_en_passant >> 7);
+    fen += (stm == Side::WHITE) ? " w " : " b ";
+    // the castling bits are white then black kingside, followed by white then black queenside
+    std::string castling;
+    for (const auto& [bit, c] : {std::make_pair(0, 'K'), std::make_pair(2, 'Q'), std::make_pair(1, 'k'), std::make_pair(3, 'q')}) {
+        if (get_bit(packed.castling, bit)) {
+            castling += c;
+        }
+    }
+    fen += castling.empty() ? "-" : castling;
+    const auto en_passant_file = packed.stm_en_passant & 0x7F;
+    if (en_passant_file == 9) {
+        fen += " -";
+    } else {
+        fen += std::string(" ") + static_cast<char>('a' + en_passant_file) + ((stm == Side::WHITE) ? '6' : '3');
+    }
+    return fen + " " + std::to_string(packed.halfmove_clock) + " " + std::to_string(packed.fullmove_counter);
+}
+
+struct DatagenState {
+    std::ofstream output;
+    std::mutex output_mutex;
+    std::atomic<uint64_t> positions_written = 0;
+    std::atomic<uint64_t> games_played = 0;
+    uint64_t position_count;
+    uint64_t nodes;
+};
+
+/**
+ * @brief Plays games until enough positions have been written.  Each thread has its own search handler and transposition table, so
+ * the only shared state is the output file
+ */
+void play_datagen_games(DatagenState& state, uint64_t seed) {
+    TranspositionTable table;
+    SearchHandler handler(table);
+    handler.set_print_info(false);
+    std::mt19937_64 rng(seed);
+    std::vector<Datagen::PackedPosition> game_positions;
+
+    while (state.positions_written < state.position_count) {
+        handler.reset();
+        Position start;
+        start.set_from_fen("startpos");
+        handler.set_pos(start);
+
+        // a random opening, with a random number of plies so that both sides get to start from unbalanced positions
+        const int random_plies = datagen_random_plies + (rng() & 1);
+        bool valid_opening = true;
+        for (int i = 0; i < random_plies && valid_opening; i++) {
+            const auto moves = MoveGenerator::generate_legal_moves<MoveGenType::ALL_LEGAL>(handler.get_pos(), handler.get_pos().stm());
+            valid_opening = moves.size() != 0;
+            if (valid_opening) {
+                handler.get_pos().make_move(moves[rng() % moves.size()].move, handler.get_history());
+            }
+        }
+        if (!valid_opening) {
+            continue;
+        }
+
+        game_positions.clear();
+        uint8_t result = 1;
+        for (int ply = 0;; ply++) {
+            const auto& pos = handler.get_pos();
+            const auto moves = MoveGenerator::generate_legal_moves<MoveGenType::ALL_LEGAL>(pos, pos.stm());
+            if (moves.size() == 0) {
+                result = pos.in_check() ? ((pos.stm() == Side::WHITE) ? 0 : 2) : 1;
+                break;
+            }
+            if (ply >= datagen_max_plies || Search::is_draw(pos, handler.get_history())) {
+                break;
+            }
+
+            const auto [move, score] = handler.search_sync(NodeTC{state.nodes, state.nodes * 16});
+            const Score white_score = (pos.stm() == Side::WHITE) ? score : -score;
+            if (std::abs(score) >= datagen_win_adjudication) {
+                result = (white_score > 0) ? 2 : 0;
+                break;
+            }
+            // positions where the best move is tactical, or where the side to move is in check, tell a net little about the
+            // evaluation as the score depends on the search resolving the tactics
+            if (!pos.in_check() && !move.is_noisy() && moves.size() > 1) {
+                game_positions.push_back(Datagen::pack_position(pos, white_score, 0));
+            }
+            pos.make_move(move, handler.get_history());
+        }
+
+        for (auto& packed : game_positions) {
+            packed.result = result;
+        }
+        std::lock_guard<std::mutex> lock(state.output_mutex);
+        state.output.write(reinterpret_cast<const char*>(game_positions.data()), game_positions.size() * sizeof(Datagen::PackedPosition));
+        state.positions_written += game_positions.size();
+        state.games_played += 1;
+    }
+}
+
+/**
+ * @brief Generates training data by self-play with fixed node searches from randomised openings, appending each game's positions to
+ * the output file as it finishes
+ */
+void Datagen::run_datagen(const std::string& output_path, uint64_t position_count, int thread_count, uint64_t nodes) {
+    DatagenState state;
+    state.output.open(output_path, std::ios::binary | std::ios::app);
+    state.position_count = position_count;
+    state.nodes = nodes;
+
+    std::random_device random_device;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < std::max(thread_count, 1); i++) {
+        threads.emplace_back(play_datagen_games, std::ref(state), (static_cast<uint64_t>(random_device()) << 32) | random_device());
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto report = [&]() {
+        const auto elapsed = std::max(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), 0.001);
+        printf("%lu games, %lu positions, %.0f positions/s\n", state.games_played.load(), state.positions_written.load(),
+               state.positions_written / elapsed);
+        fflush(stdout);
+    };
+    for (int seconds = 1; state.positions_written < position_count; seconds++) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        if (seconds % 10 == 0) {
+            report();
+        }
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    report();
+}
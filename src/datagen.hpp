@@ -0,0 +1,30 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+#include "chessboard.hpp"
+
+namespace Datagen {
+    /**
+     * @brief A scored position packed into 32 bytes for training.  Pieces are stored one per nibble as (side << 3) | piece type, in
+     * the order of the set bits of the occupancy
+     */
+    struct PackedPosition {
+        uint64_t occupancy;
+        std::array<uint8_t, 16> pieces;
+        int16_t score; // from white's perspective
+        uint16_t fullmove_counter;
+        uint8_t result; // 0, 1 or 2 for a black win, a draw or a white win
+        uint8_t stm_en_passant; // the side to move in the top bit, the en passant file (or 9 if there isn't one) in the rest
+        uint8_t castling;
+        uint8_t halfmove_clock;
+    };
+    static_assert(sizeof(PackedPosition) == 32);
+
+    PackedPosition pack_position(const Position& pos, Score white_score, uint8_t result);
+    std::string unpack_to_fen(const PackedPosition& packed);
+
+    void run_datagen(const std::string& output_path, uint64_t position_count, int thread_count, uint64_t nodes);
+} // namespace Datagen
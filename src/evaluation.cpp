@@ -1,8 +1,10 @@
 #include "evaluation.hpp"
 
+#include <algorithm>
 #include <bit>
 
 #include "magic_numbers.hpp"
+#include "magic_numbers/eval_terms.hpp"
 #include "move_generator.hpp"
 #include "search.hpp"
 
@@ -10,15 +12,268 @@ int32_t get_eg_score(int32_t score) { return std::bit_cast<int16_t>(static_cast<
 
 int32_t get_mg_score(int32_t score) { return std::bit_cast<int16_t>(static_cast<uint16_t>(score)); }
 
-Score Evaluation::evaluate_board(const Position& board) {
+consteval MDArray<Bitboard, 2, 64> compute_forward_file_masks() {
+    MDArray<Bitboard, 2, 64> to_return = {};
+    for (Square sq = Square::A1; sq != Square::NONE; sq++) {
+        for (int rnk = rank(sq) + 1; rnk < 8; rnk++) {
+            to_return[static_cast<int>(Side::WHITE)][sq_to_int(sq)] |= get_position(rnk, file(sq));
+        }
+        for (int rnk = rank(sq) - 1; rnk >= 0; rnk--) {
+            to_return[static_cast<int>(Side::BLACK)][sq_to_int(sq)] |= get_position(rnk, file(sq));
+        }
+    }
+    return to_return;
+}
+
+consteval std::array<Bitboard, 8> compute_adjacent_files() {
+    std::array<Bitboard, 8> to_return = {};
+    for (int fl = 0; fl < 8; fl++) {
+        to_return[fl] = (fl > 0 ? file_bb(fl - 1) : Bitboard(0)) | (fl < 7 ? file_bb(fl + 1) : Bitboard(0));
+    }
+    return to_return;
+}
+
+constexpr MDArray<Bitboard, 2, 64> ForwardFileMasks = compute_forward_file_masks();
+constexpr std::array<Bitboard, 8> AdjacentFiles = compute_adjacent_files();
+
+/**
+ * @brief The squares a pawn must pass through, or that an enemy pawn could capture it from, on the way to promoting.  If no enemy pawns
+ * are on these squares the pawn is passed
+ */
+consteval MDArray<Bitboard, 2, 64> compute_passed_pawn_masks() {
+    const auto forward_file_masks = compute_forward_file_masks();
+    MDArray<Bitboard, 2, 64> to_return = {};
+    for (int side = 0; side < 2; side++) {
+        for (Square sq = Square::A1; sq != Square::NONE; sq++) {
+            const auto forward = forward_file_masks[side][sq_to_int(sq)];
+            to_return[side][sq_to_int(sq)] = forward | ((forward << 1) & ~file_bb(0)) | ((forward >> 1) & ~file_bb(7));
+        }
+    }
+    return to_return;
+}
+
+constexpr MDArray<Bitboard, 2, 64> PassedPawnMasks = compute_passed_pawn_masks();
+
+template <Side side> Bitboard pawn_attacks(const Bitboard pawns) {
+    if constexpr (side == Side::WHITE) {
+        return ((pawns & ~file_bb(0)) << 7) | ((pawns & ~file_bb(7)) << 9);
+    } else {
+        return ((pawns & ~file_bb(0)) >> 9) | ((pawns & ~file_bb(7)) >> 7);
+    }
+}
+
+// +1 for white's terms and -1 for black's, matching the sign they have in a white-relative score
+template <Side side> constexpr int trace_sign() { return side == Side::WHITE ? 1 : -1; }
+
+template <Side side, bool traced = false> int32_t evaluate_pawns(const Position& board, Evaluation::EvalTrace* trace = nullptr) {
+    constexpr auto enemy = enemy_side(side);
+    constexpr auto side_idx = static_cast<int>(side);
+    const auto friendly_pawns = board.pawns(side);
+    const auto enemy_pawns = board.pawns(enemy);
+    const auto enemy_attacks = pawn_attacks<enemy>(enemy_pawns);
+
+    int32_t score = 0;
+    auto pawns = friendly_pawns;
+    while (!pawns.empty()) {
+        const auto sq = pawns.pop_lsb();
+        const auto adjacent_pawns = friendly_pawns & AdjacentFiles[file(sq)];
+        const bool doubled = !(friendly_pawns & ForwardFileMasks[side_idx][sq_to_int(sq)]).empty();
+
+        if (doubled) {
+            score += EvalTerms::DoubledPawn;
+            if constexpr (traced) {
+                trace->doubled_pawn += trace_sign<side>();
+            }
+        }
+        if (adjacent_pawns.empty()) {
+            score += EvalTerms::IsolatedPawn;
+            if constexpr (traced) {
+                trace->isolated_pawn += trace_sign<side>();
+            }
+        } else if ((adjacent_pawns & ~PassedPawnMasks[side_idx][sq_to_int(sq)]).empty()
+                   && enemy_attacks[sq_to_int(sq) + (side == Side::WHITE ? 8 : -8)]) {
+            // no pawn can ever defend this one, and it can't advance without being captured
+            score += EvalTerms::BackwardPawn;
+            if constexpr (traced) {
+                trace->backward_pawn += trace_sign<side>();
+            }
+        }
+        if (!doubled && (enemy_pawns & PassedPawnMasks[side_idx][sq_to_int(sq)]).empty()) {
+            const auto relative_rank = side == Side::WHITE ? rank(sq) : 7 - rank(sq);
+            score += EvalTerms::PassedPawn[relative_rank];
+            if constexpr (traced) {
+                trace->passed_pawn[relative_rank] += trace_sign<side>();
+            }
+        }
+    }
+    return score;
+}
+
+template <Side side, bool traced = false> int32_t evaluate_pawn_shield(const Position& board, Evaluation::EvalTrace* trace = nullptr) {
+    const auto ksq = board.kings(side).lsb();
+    const auto shield_pawns = board.pawns(side) & (AdjacentFiles[file(ksq)] | file_bb(file(ksq)));
+    int32_t score = 0;
+    for (int i = 0; i < 2; i++) {
+        const int shield_rank = side == Side::WHITE ? rank(ksq) + 1 + i : rank(ksq) - 1 - i;
+        if (shield_rank < 0 || shield_rank > 7) {
+            break;
+        }
+        const auto shield_count = (shield_pawns & rank_bb(shield_rank)).popcnt();
+        score += EvalTerms::PawnShield[i] * shield_count;
+        if constexpr (traced) {
+            trace->pawn_shield[i] += trace_sign<side>() * shield_count;
+        }
+    }
+    return score;
+}
+
+template <PieceTypes piece_type> constexpr auto& mobility_table() {
+    if constexpr (piece_type == PieceTypes::KNIGHT) {
+        return EvalTerms::KnightMobility;
+    } else if constexpr (piece_type == PieceTypes::BISHOP) {
+        return EvalTerms::BishopMobility;
+    } else if constexpr (piece_type == PieceTypes::ROOK) {
+        return EvalTerms::RookMobility;
+    } else {
+        return EvalTerms::QueenMobility;
+    }
+}
+
+template <PieceTypes piece_type> auto& mobility_trace(Evaluation::EvalTrace& trace) {
+    if constexpr (piece_type == PieceTypes::KNIGHT) {
+        return trace.knight_mobility;
+    } else if constexpr (piece_type == PieceTypes::BISHOP) {
+        return trace.bishop_mobility;
+    } else if constexpr (piece_type == PieceTypes::ROOK) {
+        return trace.rook_mobility;
+    } else {
+        return trace.queen_mobility;
+    }
+}
+
+struct PieceEvalState {
+    int32_t score = 0;
+    int king_attack_units = 0;
+    int king_attackers = 0;
+};
+
+/**
+ * @brief Scores the mobility and king zone attacks of every piece of one type, returning the union of their attacks for the threat terms
+ */
+template <PieceTypes piece_type, Side side, bool traced>
+Bitboard evaluate_piece_type(const Position& board, const Bitboard mobility_area, const Bitboard king_zone, PieceEvalState& state,
+                             Evaluation::EvalTrace* trace) {
+    const auto occupied = board.occupancy();
+    Bitboard all_attacks = 0;
+    auto pieces = board.pieces<piece_type>(side);
+    while (!pieces.empty()) {
+        const auto attacks = MoveGenerator::generate_mm<piece_type>(occupied, pieces.pop_lsb());
+        all_attacks |= attacks;
+        const auto mobility = (attacks & mobility_area).popcnt();
+        state.score += mobility_table<piece_type>()[mobility];
+        if constexpr (traced) {
+            mobility_trace<piece_type>(*trace)[mobility] += trace_sign<side>();
+        }
+        // most pieces don't touch the king zone, so skip the count for them
+        const auto zone_attacks = attacks & king_zone;
+        if (!zone_attacks.empty()) {
+            state.king_attack_units += EvalTerms::KingAttackWeights[static_cast<int>(piece_type)] * zone_attacks.popcnt();
+            state.king_attackers += 1;
+        }
+    }
+    return all_attacks;
+}
+
+/**
+ * @brief Scores mobility, attacks on the enemy king zone and threats against enemy pieces.  Mobility needs each piece's own attack count, but
+ * the threat terms work on the union of every attack from a piece type at once
+ */
+template <Side side, bool traced = false> int32_t evaluate_pieces(const Position& board, Evaluation::EvalTrace* trace = nullptr) {
+    constexpr auto enemy = enemy_side(side);
+    const auto enemy_ksq = board.kings(enemy).lsb();
+    const auto king_zone = MagicNumbers::KingMoves[sq_to_int(enemy_ksq)] | Bitboard(enemy_ksq);
+    const auto mobility_area = ~(board.pawns(side) | board.kings(side) | pawn_attacks<enemy>(board.pawns(enemy)));
+
+    PieceEvalState state;
+    const auto knight_attacks = evaluate_piece_type<PieceTypes::KNIGHT, side, traced>(board, mobility_area, king_zone, state, trace);
+    const auto bishop_attacks = evaluate_piece_type<PieceTypes::BISHOP, side, traced>(board, mobility_area, king_zone, state, trace);
+    const auto rook_attacks = evaluate_piece_type<PieceTypes::ROOK, side, traced>(board, mobility_area, king_zone, state, trace);
+    evaluate_piece_type<PieceTypes::QUEEN, side, traced>(board, mobility_area, king_zone, state, trace);
+
+    int32_t score = state.score;
+    if (state.king_attackers >= 2) {
+        const auto king_attack_units = std::min(state.king_attack_units, EvalTerms::MaxKingAttackUnits);
+        score += EvalTerms::KingAttack[king_attack_units];
+        if constexpr (traced) {
+            trace->king_attack[king_attack_units] += trace_sign<side>();
+        }
+    }
+
+    const auto enemy_pieces = board.occupancy(enemy) & ~board.pawns(enemy) & ~board.kings(enemy);
+    const auto enemy_majors = board.rooks(enemy) | board.queens(enemy);
+    const auto pawn_threats = (pawn_attacks<side>(board.pawns(side)) & enemy_pieces).popcnt();
+    const auto minor_threats = ((knight_attacks | bishop_attacks) & enemy_majors).popcnt();
+    const auto rook_threats = (rook_attacks & board.queens(enemy)).popcnt();
+    score += EvalTerms::PawnThreat * pawn_threats + EvalTerms::MinorThreat * minor_threats + EvalTerms::RookThreat * rook_threats;
+    if constexpr (traced) {
+        trace->pawn_threat += trace_sign<side>() * pawn_threats;
+        trace->minor_threat += trace_sign<side>() * minor_threats;
+        trace->rook_threat += trace_sign<side>() * rook_threats;
+    }
+    return score;
+}
+
+int32_t Evaluation::evaluate_pawn_structure(const Position& board) { return evaluate_pawns<Side::WHITE>(board) - evaluate_pawns<Side::BLACK>(board); }
+
+int32_t evaluate_king_and_pieces(const Position& board) {
+    return evaluate_pawn_shield<Side::WHITE>(board) - evaluate_pawn_shield<Side::BLACK>(board) + evaluate_pieces<Side::WHITE>(board) -
+           evaluate_pieces<Side::BLACK>(board);
+}
+
+Evaluation::EvalTrace Evaluation::trace_positional_terms(const Position& board) {
+    EvalTrace trace;
+    evaluate_pawns<Side::WHITE, true>(board, &trace);
+    evaluate_pawns<Side::BLACK, true>(board, &trace);
+    evaluate_pawn_shield<Side::WHITE, true>(board, &trace);
+    evaluate_pawn_shield<Side::BLACK, true>(board, &trace);
+    evaluate_pieces<Side::WHITE, true>(board, &trace);
+    evaluate_pieces<Side::BLACK, true>(board, &trace);
+    return trace;
+}
+
+/**
+ * @brief Combines the incrementally updated piece-square scores with the pawn structure score, which is given from white's perspective.
+ * The pawn shield and the piece terms depend on more than the pawns, so they're computed here rather than stored in the pawn table
+ *
+ * @param board
+ * @param pawn_score
+ * @return Score
+ */
+Score evaluate_with_pawn_score(const Position& board, int32_t pawn_score) {
     const Side stm = board.stm();
     const Side enemy = enemy_side(board.stm());
-    const auto mg_score = get_mg_score(board.get_score(stm)) - get_mg_score(board.get_score(enemy));
-    const auto eg_score = get_eg_score(board.get_score(stm)) - get_eg_score(board.get_score(enemy));
+    pawn_score += evaluate_king_and_pieces(board);
+    if (stm == Side::BLACK) {
+        pawn_score = -pawn_score;
+    }
+    const auto mg_score = get_mg_score(board.get_score(stm)) - get_mg_score(board.get_score(enemy)) + get_mg_score(pawn_score);
+    const auto eg_score = get_eg_score(board.get_score(stm)) - get_eg_score(board.get_score(enemy)) + get_eg_score(pawn_score);
 
     const auto mg_phase = std::min(board.get_mg_phase(), (uint8_t) 24);
     const auto eg_phase = 24 - mg_phase;
 
-    return std::clamp((((mg_score * mg_phase) + (eg_score * eg_phase)) / 24) + 5, MagicNumbers::NegativeInfinity + MAX_PLY + 1,
+    return std::clamp((((mg_score * mg_phase) + (eg_score * eg_phase)) / 24) + EvalTerms::Tempo, MagicNumbers::NegativeInfinity + MAX_PLY + 1,
                       MagicNumbers::PositiveInfinity - MAX_PLY - 1);
-}
\ No newline at end of file
+}
+
+Score Evaluation::evaluate_board(const Position& board) { return evaluate_with_pawn_score(board, evaluate_pawn_structure(board)); }
+
+Score Evaluation::evaluate_board(const Position& board, PawnTable& pawn_table) {
+    const auto cached = pawn_table.probe(board.pawn_hash());
+    if (cached.has_value()) {
+        return evaluate_with_pawn_score(board, *cached);
+    }
+    const auto pawn_score = evaluate_pawn_structure(board);
+    pawn_table.store(board.pawn_hash(), pawn_score);
+    return evaluate_with_pawn_score(board, pawn_score);
+}
@@ -3,13 +3,39 @@
 #include <array>
 #include <cstdint>
 
+#include "magic_numbers/eval_terms.hpp"
 #include "magic_numbers/piece_square_tables.hpp"
 #include "chessboard.hpp"
+#include "hash_cache.hpp"
 #include "utils.hpp"
 
-#define MOBILITY_WEIGHT 10
-// the number of centipawns each possible move is worth
+int32_t get_mg_score(int32_t score);
+int32_t get_eg_score(int32_t score);
 
 namespace Evaluation {
     Score evaluate_board(const Position& c);
+    Score evaluate_board(const Position& c, PawnTable& pawn_table);
+    int32_t evaluate_pawn_structure(const Position& c);
+
+    /**
+     * @brief How many times each term outside the piece-square tables applies to a position, white's count less black's.  The
+     * evaluation is a sum of these counts times the terms' weights, which is what lets the tuner fit the weights
+     */
+    struct EvalTrace {
+        std::array<int, EvalTerms::PassedPawn.size()> passed_pawn = {};
+        int isolated_pawn = 0;
+        int doubled_pawn = 0;
+        int backward_pawn = 0;
+        std::array<int, EvalTerms::PawnShield.size()> pawn_shield = {};
+        std::array<int, EvalTerms::KnightMobility.size()> knight_mobility = {};
+        std::array<int, EvalTerms::BishopMobility.size()> bishop_mobility = {};
+        std::array<int, EvalTerms::RookMobility.size()> rook_mobility = {};
+        std::array<int, EvalTerms::QueenMobility.size()> queen_mobility = {};
+        std::array<int, EvalTerms::KingAttack.size()> king_attack = {};
+        int pawn_threat = 0;
+        int minor_threat = 0;
+        int rook_threat = 0;
+    };
+
+    EvalTrace trace_positional_terms(const Position& c);
 } // namespace Evaluation
\ No newline at end of file
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <optional>
+
+#include "utils.hpp"
+
+template <typename T> struct HashCacheEntry {
+    ZobristKey key = 0;
+    T value = 0;
+};
+
+/**
+ * @brief A direct-mapped cache of values that are expensive to compute from a position, indexed by one of its hash keys.  Each search
+ * thread owns its own caches, so no synchronisation is needed.  A cleared entry matches a key of 0 with a value of 0
+ *
+ * @tparam T The cached value
+ * @tparam size The number of entries, which must be a power of two
+ */
+template <typename T, size_t size> class HashCache {
+    private:
+        static_assert((size & (size - 1)) == 0);
+
+        std::unique_ptr<std::array<HashCacheEntry<T>, size>> table;
+        uint64_t _hits = 0;
+        uint64_t _misses = 0;
+
+        static size_t index(const ZobristKey key) { return key & (size - 1); };
+
+    public:
+        HashCache() : table(std::make_unique<std::array<HashCacheEntry<T>, size>>()) {};
+
+        std::optional<T> probe(const ZobristKey key) {
+            const auto& entry = (*table)[index(key)];
+            if (entry.key == key) {
+                _hits += 1;
+                return entry.value;
+            }
+            _misses += 1;
+            return std::nullopt;
+        }
+
+        void store(const ZobristKey key, const T value) { (*table)[index(key)] = HashCacheEntry<T>{key, value}; };
+
+        void clear() {
+            table->fill(HashCacheEntry<T>());
+            _hits = 0;
+            _misses = 0;
+        }
+
+        uint64_t hits() const { return _hits; };
+        uint64_t misses() const { return _misses; };
+};
+
+// Pawns move far less often than anything else, so nearly every probe in search hits.  A position with no pawns has a pawn hash of 0 and
+// a pawn structure score of 0
+using PawnTable = HashCache<int32_t, 16384>;
+// The transposition table already holds the static eval of most positions; this catches the ones it has dropped or never stored
+using EvalCache = HashCache<Score, 65536>;
@@ -4,32 +4,33 @@
 
 #include "search.hpp"
 
-HistoryValue HistoryTable::score(const BoardHistory& hist, Move move, Side stm) const {
+HistoryValue HistoryTable::score(const Position& pos, const SearchStackFrame& parent, Move move) const {
     if (move.is_noisy()) {
-        return capthist_score(hist, move);
+        return capthist_score(pos, move);
     } else {
-        return mainhist_score(move, stm) + 2 * conthist_score(hist, move);
+        return mainhist_score(move, pos.stm()) + 2 * conthist_score(pos, parent, move);
     }
 }
 
-void HistoryTable::update_scores(const BoardHistory& hist, std::span<const Move> moves, ScoredMove current_move, Side stm, int depth) {
+void HistoryTable::update_scores(const Position& pos, const SearchStackFrame& parent, std::span<const Move> moves, ScoredMove current_move, int depth) {
+    const auto stm = pos.stm();
     const auto hist_bonus = bonus(depth);
     const auto hist_malus = malus(depth);
     if (!current_move.move.is_noisy()) {
         update_mainhist_score(current_move.move, stm, hist_bonus);
-        update_conthist_score(hist, current_move.move, hist_bonus);
+        update_conthist_score(pos, parent, current_move.move, hist_bonus);
         std::for_each(moves.begin(), moves.end(), [&](Move move) {
             if (!move.is_noisy()) {
                 update_mainhist_score(move, stm, hist_malus);
-                update_conthist_score(hist, move, hist_malus);
+                update_conthist_score(pos, parent, move, hist_malus);
             }
         });
     } else {
-        update_capthist_score(hist, current_move.move, hist_bonus);
+        update_capthist_score(pos, current_move.move, hist_bonus);
     }
     std::for_each(moves.begin(), moves.end(), [&](Move move) {
         if (move.is_noisy() && move != current_move.move) {
-            update_capthist_score(hist, move, hist_malus);
+            update_capthist_score(pos, move, hist_malus);
         }
     });
 }
@@ -40,36 +41,34 @@ void HistoryTable::update_mainhist_score(Move move, Side stm, HistoryValue bonus
 }
 
 
-void HistoryTable::update_conthist_score(const BoardHistory& hist, Move move, HistoryValue bonus) {
-    if (!hist.move_at(hist.len() - 1).is_null_move()) {
-        const auto scaled_bonus = bonus - conthist_score(hist, move) * std::abs(bonus) / 32768;
-        (*cont_hist)[hist[hist.len() - 2].piece_to(hist.move_at(hist.len() - 1))][hist[hist.len() - 1].piece_to(move)] += scaled_bonus;
+void HistoryTable::update_conthist_score(const Position& pos, const SearchStackFrame& parent, Move move, HistoryValue bonus) {
+    if (!parent.current_move.is_null_move()) {
+        const auto scaled_bonus = bonus - conthist_score(pos, parent, move) * std::abs(bonus) / 32768;
+        (*cont_hist)[parent.piece_to()][pos.piece_to(move)] += scaled_bonus;
     }
 }
 
-HistoryValue HistoryTable::conthist_score(const BoardHistory& hist, Move move) const {
-    if (!hist.move_at(hist.len() - 1).is_null_move()) {
-        return (*cont_hist)[hist[hist.len() - 2].piece_to(hist.move_at(hist.len() - 1))][hist[hist.len() - 1].piece_to(move)];
+HistoryValue HistoryTable::conthist_score(const Position& pos, const SearchStackFrame& parent, Move move) const {
+    if (!parent.current_move.is_null_move()) {
+        return (*cont_hist)[parent.piece_to()][pos.piece_to(move)];
     } else {
         return 0;
     }
 }
 
 
-HistoryValue HistoryTable::capthist_score(const BoardHistory& hist, const Move move) const {
-    const auto& pos = hist[hist.len() - 1];
+HistoryValue HistoryTable::capthist_score(const Position& pos, const Move move) const {
     const auto captured_type = (move.is_promotion() || move.flags() == MoveFlags::EN_PASSANT_CAPTURE)
         ? PieceTypes::PAWN
         : pos.piece_at(move.dst_sq()).type();
     return (*capt_hist)[pos.piece_to(move)][static_cast<int>(captured_type) - 1];
 }
 
-void HistoryTable::update_capthist_score(const BoardHistory& hist, Move move, HistoryValue bonus) {
-    const auto& pos = hist[hist.len() - 1];
+void HistoryTable::update_capthist_score(const Position& pos, Move move, HistoryValue bonus) {
     const auto captured_type = (move.is_promotion() || move.flags() == MoveFlags::EN_PASSANT_CAPTURE)
         ? PieceTypes::PAWN
         : pos.piece_at(move.dst_sq()).type();
-    const auto scaled_bonus = bonus - capthist_score(hist, move) * std::abs(bonus) / 32768;
+    const auto scaled_bonus = bonus - capthist_score(pos, move) * std::abs(bonus) / 32768;
     (*capt_hist)[pos.piece_to(move)][static_cast<int>(captured_type) - 1] += scaled_bonus;
 }
 
@@ -10,6 +10,7 @@
 #include "chessboard.hpp"
 #include "mdarray.hpp"
 #include "move.hpp"
+#include "search_stack.hpp"
 #include "utils.hpp"
 
 using HistoryValue = int32_t;
@@ -33,16 +34,16 @@ class HistoryTable {
             clear(); 
         };
 
-        HistoryValue score(const BoardHistory& hist, Move move, Side stm) const;
+        HistoryValue score(const Position& pos, const SearchStackFrame& parent, Move move) const;
         HistoryValue mainhist_score(Move move, Side stm) const { return main_hist[move.hist_idx(stm)]; };
-        HistoryValue conthist_score(const BoardHistory& hist, Move move) const;
-        HistoryValue capthist_score(const BoardHistory& hist, const Move move) const;
+        HistoryValue conthist_score(const Position& pos, const SearchStackFrame& parent, Move move) const;
+        HistoryValue capthist_score(const Position& pos, const Move move) const;
         Score corrhist_score(const Position& pos, const Score static_eval) const;
 
-        void update_scores(const BoardHistory& hist, std::span<const Move> moves, ScoredMove current_move, Side stm, int depth);
+        void update_scores(const Position& pos, const SearchStackFrame& parent, std::span<const Move> moves, ScoredMove current_move, int depth);
         void update_mainhist_score(Move move, Side stm, HistoryValue bonus);
-        void update_conthist_score(const BoardHistory& hist, Move move, HistoryValue bonus);
-        void update_capthist_score(const BoardHistory& hist, Move move, HistoryValue bonus);
+        void update_conthist_score(const Position& pos, const SearchStackFrame& parent, Move move, HistoryValue bonus);
+        void update_capthist_score(const Position& pos, Move move, HistoryValue bonus);
         void update_corrhist_score(const Position& pos, const Score static_eval, const Score search_score, const int depth);
         void clear() { 
             std::for_each(cont_hist->begin(), cont_hist->end(), [](auto& arr) { arr.fill(0); });
@@ -5,24 +5,36 @@
 #include <limits>
 
 #include "bitboard.hpp"
+#include "magic_numbers/bishop_magics.hpp"
+#include "magic_numbers/rook_magics.hpp"
 #include "mdarray.hpp"
 #include "utils.hpp"
 
-#define BISHOP_MOVES 512
-#define ROOK_MOVES 4096
-
-
 namespace MagicNumbers {
-    extern const Bitboard RookMagics[64];
-    extern const Bitboard BishopMagics[64];
-    extern const Bitboard RookMasks[64];
-    extern const Bitboard BishopMasks[64];
-
-    extern const int RookBits[64];
-    extern const int BishopBits[64];
-
-    extern const MDArray<Bitboard, 64, 512> BishopAttacks;
-    extern const MDArray<Bitboard, 64, 4096> RookAttacks;
+    /**
+     * @brief Computes where each square's attack set starts within SliderAttacks.  Each square only takes up as many entries as its
+     * magic index can produce (1 << bits), rather than the worst case for that piece type, so the rook and bishop attack sets can be
+     * packed together into a single table
+     *
+     * @param bits The number of index bits for each square
+     * @param base The offset of the first square
+     * @return consteval
+     */
+    consteval std::array<uint32_t, 65> compute_magic_offsets(const int (&bits)[64], const uint32_t base) {
+        std::array<uint32_t, 65> to_return = {0};
+        to_return[0] = base;
+        for (int sq = 0; sq < 64; sq++) {
+            to_return[sq + 1] = to_return[sq] + (1 << bits[sq]);
+        }
+        return to_return;
+    }
+
+    // The rook entries come first, followed by the bishop entries; the final element of each is the end of that piece's section
+    constexpr std::array<uint32_t, 65> RookOffsets = compute_magic_offsets(RookBits, 0);
+    constexpr std::array<uint32_t, 65> BishopOffsets = compute_magic_offsets(BishopBits, RookOffsets[64]);
+    constexpr size_t SliderAttacksSize = BishopOffsets[64];
+
+    extern const std::array<Bitboard, SliderAttacksSize> SliderAttacks;
 
     extern const MDArray<Bitboard, 64, 64> ConnectingSquares;
     extern const MDArray<Bitboard, 64, 64> AlignedSquares;
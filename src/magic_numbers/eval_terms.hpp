@@ -0,0 +1,65 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+
+#include "piece_square_tables.hpp"
+
+namespace EvalTerms {
+    // clang-format off
+
+    // indexed by the pawn's rank relative to its own side
+    constexpr std::array<int32_t, 8> PassedPawn = {
+        S(  0,  0), S( -5,  5), S( -5, 10), S(  0, 20), S( 15, 40), S( 30, 70), S( 40,100), S(  0,  0),
+    };
+
+    constexpr int32_t IsolatedPawn = S(-10,-15);
+    constexpr int32_t DoubledPawn = S(-10,-30);
+    constexpr int32_t BackwardPawn = S( -8,-10);
+
+    // per friendly pawn on the king's file or an adjacent one, one or two ranks in front of the king
+    constexpr std::array<int32_t, 2> PawnShield = { S( 12,  0), S(  6,  0) };
+
+    // indexed by the number of safe squares a piece attacks; squares holding a friendly pawn or king, or attacked by an enemy pawn, don't count
+    constexpr std::array<int32_t, 9> KnightMobility = {
+        S(-30,-40), S(-15,-25), S( -6,-12), S(  0, -3), S(  3,  3), S(  6,  6), S(  9,  8), S( 12,  8), S( 15,  6),
+    };
+
+    constexpr std::array<int32_t, 14> BishopMobility = {
+        S(-28,-40), S(-15,-22), S( -6,-12), S(  0, -5), S(  3,  0), S(  6,  3), S(  9,  6), S( 11,  8), S( 12, 10), S( 13, 11),
+        S( 15, 12), S( 17, 12), S( 18, 12), S( 20, 10),
+    };
+
+    constexpr std::array<int32_t, 15> RookMobility = {
+        S(-30,-45), S(-15,-25), S( -7,-12), S( -4, -5), S( -2,  0), S(  0,  4), S(  2,  8), S(  4, 11), S(  5, 14), S(  6, 16),
+        S(  8, 18), S(  9, 20), S( 10, 21), S( 11, 22), S( 12, 23),
+    };
+
+    constexpr std::array<int32_t, 28> QueenMobility = {
+        S(-20,-35), S(-14,-25), S( -9,-17), S( -6,-11), S( -3, -6), S( -1, -2), S(  1,  1), S(  2,  4), S(  3,  7), S(  4,  9),
+        S(  5, 11), S(  6, 13), S(  7, 15), S(  8, 16), S(  9, 17), S( 10, 18), S( 11, 19), S( 12, 20), S( 12, 21), S( 13, 22),
+        S( 13, 22), S( 14, 23), S( 14, 23), S( 15, 24), S( 15, 24), S( 16, 25), S( 16, 25), S( 17, 25),
+    };
+
+    // attack units per square of the enemy king zone (the king and its neighbouring squares) attacked, indexed by piece type
+    constexpr std::array<int, 7> KingAttackWeights = { 0, 0, 2, 2, 3, 5, 0 };
+    constexpr int MaxKingAttackUnits = 40;
+
+    // only applied if at least two pieces attack the king zone; grows quadratically so coordinated attacks are worth more than their parts
+    constexpr std::array<int32_t, MaxKingAttackUnits + 1> KingAttack = []() {
+        std::array<int32_t, MaxKingAttackUnits + 1> to_return = {};
+        for (int units = 0; units <= MaxKingAttackUnits; units++) {
+            to_return[units] = S(std::min(units * units / 3, 300), units);
+        }
+        return to_return;
+    }();
+
+    constexpr int32_t PawnThreat = S( 35, 20);      // a pawn attacking an enemy piece
+    constexpr int32_t MinorThreat = S( 25, 15);     // a knight or bishop attacking an enemy rook or queen
+    constexpr int32_t RookThreat = S( 25, 10);      // a rook attacking an enemy queen
+
+    // added for the side to move after tapering
+    constexpr int Tempo = 5;
+
+    // clang-format on
+} // namespace EvalTerms
@@ -105,6 +105,44 @@ consteval MDArray<Bitboard, 64, 64> compute_aligned_squares() {
 
 constexpr MDArray<Bitboard, 64, 64> MagicNumbers::AlignedSquares = compute_aligned_squares();
 
+/**
+ * @brief Fills in one piece type's section of the shared slider attack table, enumerating every subset of each square's mask and storing
+ * its attacks at that square's offset plus the magic index
+ *
+ * @param table The shared attack table
+ * @param masks
+ * @param magics
+ * @param bits
+ * @param offsets
+ * @param generate_attacks The ray-walking attack generator for this piece type
+ */
+template <typename F>
+constexpr void fill_slider_attacks(std::array<Bitboard, MagicNumbers::SliderAttacksSize>& table, const Bitboard (&masks)[64], const Bitboard (&magics)[64],
+                                   const int (&bits)[64], const std::array<uint32_t, 65>& offsets, F generate_attacks) {
+    for (Square square = Square::A1; square != Square::NONE; square++) {
+        const auto idx = sq_to_int(square);
+        const Bitboard attack_mask = masks[idx];
+        Bitboard blockers = 0;
+        do {
+            const auto magic_idx = (blockers * magics[idx]) >> (64 - bits[idx]);
+            table[offsets[idx] + magic_idx] = generate_attacks(square, blockers);
+            blockers = (blockers - attack_mask) & attack_mask;
+            // bit twiddling trick to enumerate every subset of the mask
+        } while (!blockers.empty());
+    }
+}
+
+consteval std::array<Bitboard, MagicNumbers::SliderAttacksSize> compute_slider_attacks() {
+    std::array<Bitboard, MagicNumbers::SliderAttacksSize> to_return = {0};
+    fill_slider_attacks(to_return, MagicNumbers::RookMasks, MagicNumbers::RookMagics, MagicNumbers::RookBits, MagicNumbers::RookOffsets,
+                        generate_rook_attacks);
+    fill_slider_attacks(to_return, MagicNumbers::BishopMasks, MagicNumbers::BishopMagics, MagicNumbers::BishopBits, MagicNumbers::BishopOffsets,
+                        generate_bishop_attacks);
+    return to_return;
+}
+
+constexpr std::array<Bitboard, MagicNumbers::SliderAttacksSize> MagicNumbers::SliderAttacks = compute_slider_attacks();
+
 consteval std::array<Bitboard, 64> generate_king_moves() {
     std::array<Bitboard, 64> to_return;
     for (int rk = 0; rk < 8; rk++) {
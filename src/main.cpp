@@ -8,121 +8,41 @@
 #include <gtest/gtest.h>
 #endif
 
+#include "analyze.hpp"
 #include "chessboard.hpp"
 #include "common.hpp"
+#include "datagen.hpp"
+#include "match.hpp"
 #include "magic_numbers.hpp"
 #include "pieces.hpp"
 #include "search.hpp"
+#include "server.hpp"
+#include "spsa.hpp"
+#include "tuner.hpp"
+#include "uci.hpp"
+#include "uci_io.hpp"
 #include "uci_options.hpp"
 #include "utils.hpp"
 
 #include "move_generator.hpp"
 
-std::vector<std::string> split_on_whitespace(const std::string& data) {
-    std::vector<std::string> to_return;
-    std::string s;
-    for (auto& c : data) {
-        if (!std::isspace(c)) {
-            s.push_back(c);
-        } else if (s.length() != 0) {
-            to_return.push_back(s);
-            s = std::string();
-        }
-    }
-    if (s.length() != 0) {
-        to_return.push_back(s);
-    }
-    return to_return;
-}
-
-void process_position_command(const std::string& line, SearchHandler& s) {
-    auto parsed_line = split_on_whitespace(line);
-    int fen_idx;
-    if (parsed_line[1] == "fen") {
-        fen_idx = line.find("fen") + 3;
-        while (std::isspace(line.at(fen_idx))) {
-            fen_idx += 1;
-        }
-    } else if (parsed_line[1] == "startpos") {
-        fen_idx = line.find("startpos");
-    } else {
-        return; // not a valid position
-    }
-    auto sub_line = line.substr(fen_idx);
-    Position c;
-    auto idx = c.set_from_fen(sub_line);
-    if (idx.has_value()) {
-        auto moves = sub_line.substr(idx.value());
-        // moves is the substring starting at the end of the FEN string
-        if (moves.find("moves") != std::string::npos) {
-            // if there _are_ moves to add
-            auto split_moves = split_on_whitespace(moves.substr(moves.find(moves) + 5));
-            auto history = BoardHistory(c);
-            for (auto& move : split_moves) {
-                auto parsed_move = c.generate_move_from_string(move);
-                if (parsed_move.has_value()) {
-                    c = c.make_move(parsed_move.value(), history);
-                }
-            }
-            s.set_history(history);
-        } else {
-            s.set_pos(c);
-        }
-    }
-}
-
 void process_go_command(const std::vector<std::string>& line, SearchHandler& s) {
-    uint32_t wtime = 0, btime = 0, winc = 0, binc = 0, movetime = 0;
-    uint32_t movestogo = 1;
-    uint16_t depth = std::numeric_limits<uint16_t>::max();
-    if (line.size() == 0) {
-        s.search(InfiniteTC{});
-        return;
-    }
-    for (size_t i = 0; i < line.size(); i++) {
-        auto& this_elem = line[i];
-        if (this_elem == "infinite") {
-            s.search(InfiniteTC{});
-            return;
-        } else if (i != (line.size() - 1)) {
-            if (this_elem == "wtime") {
-                wtime = std::stoi(line[i + 1]);
-            } else if (this_elem == "btime") {
-                btime = std::stoi(line[i + 1]);
-            } else if (this_elem == "winc") {
-                winc = std::stoi(line[i + 1]);
-            } else if (this_elem == "binc") {
-                binc = std::stoi(line[i + 1]);
-            } else if (this_elem == "movetime") {
-                movetime = std::stoi(line[i + 1]);
-            } else if (this_elem == "perft") {
-                s.run_perft(std::stoi(line[i + 1]));
-                return;
-            } else if (this_elem == "movestogo") {
-                movestogo = std::stoi(line[i + 1]);
-            } else if (this_elem == "depth") {
-                depth = std::stoi(line[i + 1]);
-                s.search(DepthTC{depth});
-                return;
+    for (size_t i = 0; i + 1 < line.size(); i++) {
+        if (line[i] == "perft") {
+            if (const auto depth = parse_number<int>(line[i + 1])) {
+                s.run_perft(*depth);
+            } else {
+                uci_output().send("info string error: invalid perft depth");
             }
+            return;
         }
     }
-    if (movetime != 0) {
-        s.search(FixedTimeTC{movetime});
+    const auto tc = parse_go_command(line, s.get_pos().stm(), uci_options()["Move Overhead"]);
+    if (!tc.has_value()) {
+        uci_output().send("info string error: invalid go command");
         return;
     }
-    const auto current_side = s.get_pos().stm();
-    // auto halfmoves_so_far = (2 * s.get_pos().get_fullmove_counter()) + static_cast<int>(current_side);
-    const auto remaining_time = ((current_side == Side::WHITE) ? wtime : btime) - uci_options()["Move Overhead"];
-    const auto increment = ((current_side == Side::WHITE) ? winc : binc) / movestogo;
-    // next we determine how to use our allocated time using the formula
-    // 59.3 + (72830 - 2330 k)/(2644 + k (10 + k)), where k is the number of halfmoves
-    // so far.  This formula is taken from https://chess.stackexchange.com/questions/2506/what-is-the-average-length-of-a-game-of-chess.
-    // float remaining_halfmoves =
-    //    59.3 + (static_cast<float>(72830 - (2330 * halfmoves_so_far)) / static_cast<float>(2644 + (halfmoves_so_far * (10 + halfmoves_so_far))));
-
-    // s.search((remaining_time / static_cast<int>(remaining_halfmoves)) + increment, depth);
-    s.search(VariableTimeTC{TimeManagement::calculate_hard_limit(remaining_time, increment), remaining_time, increment});
+    s.search(*tc);
 }
 
 int main(int argc, char** argv) {
@@ -136,27 +56,156 @@ int main(int argc, char** argv) {
     uci_options().insert(std::make_pair("Hash", UCIOption(1, 2048, "16", [](UCIOption& opt) { tt.resize(size_t(opt)); })));
     uci_options().insert(std::make_pair("Threads", UCIOption(1, 1, "1", [](UCIOption& opt) { (void) opt; })));
     uci_options().insert(std::make_pair("Move Overhead", UCIOption(0, 1000, "10", [](UCIOption& opt) { (void) opt; })));
+    uci_options().insert(std::make_pair("InfoInterval", UCIOption(0, 60000, std::to_string(default_info_interval_ms), [&s](UCIOption& opt) {
+                                            s.set_info_interval(opt);
+                                        })));
+    if constexpr (search_trace_enabled) {
+        // the node window is read when the trace file is opened, so it has to be set first; an end of 0 leaves it open
+        uci_options().insert(std::make_pair("TraceNodeStart", UCIOption(0, INT32_MAX, "0", [](UCIOption& opt) { (void) opt; })));
+        uci_options().insert(std::make_pair("TraceNodeEnd", UCIOption(0, INT32_MAX, "0", [](UCIOption& opt) { (void) opt; })));
+        uci_options().insert(std::make_pair("TraceFile", UCIOption(0, 0, "", UCIOptionTypes::STRING, [&s](UCIOption& opt) {
+                                                const uint64_t end = uci_options()["TraceNodeEnd"];
+                                                s.get_tracer().set_window(static_cast<int>(uci_options()["TraceNodeStart"]),
+                                                                          end == 0 ? UINT64_MAX : end);
+                                                if (!s.get_tracer().open(opt) && std::string(opt) != "") {
+                                                    std::cout << "info string could not open trace file " << std::string(opt) << std::endl;
+                                                }
+                                            })));
+    }
 
     if (argc > 1) {
         if (std::string(argv[1]) == "bench") {
+            const auto settings = parse_bench_args(std::vector<std::string>(argv + 2, argv + argc));
+            if (!settings.has_value()) {
+                std::cout << "usage: bench [depth] [--json] [--repeat N], or bench <depth> <threads> [hash] for the multithreaded bench\n";
+                return 1;
+            }
+            if (settings->threads > 0) {
+                SearchHandler::run_smp_bench(settings->depth, settings->threads, settings->hash_mb);
+            } else {
+                s.run_bench(settings->depth, settings->json, settings->repetitions);
+            }
+            return 0;
+        } else if (std::string(argv[1]) == "movegen") {
             if (argc > 2) {
-                s.run_bench(std::stoi(argv[2]));
+                SearchHandler::run_movegen_bench(std::stoi(argv[2]));
             } else {
-                s.run_bench();
+                SearchHandler::run_movegen_bench();
+            }
+            return 0;
+        } else if (std::string(argv[1]) == "eval") {
+            if (argc > 2) {
+                SearchHandler::run_eval_bench(std::stoi(argv[2]));
+            } else {
+                SearchHandler::run_eval_bench();
+            }
+            return 0;
+        } else if (std::string(argv[1]) == "tune") {
+            const auto settings = (argc > 2) ? Tuner::parse_args(std::vector<std::string>(argv + 3, argv + argc)) : std::nullopt;
+            if (!settings.has_value()) {
+                std::cout << "usage: tune <labelled positions> [epochs] [threads] [psqt output] [terms output] [--terms-only] "
+                             "[--regularization x]\n";
+                return 1;
+            }
+            Tuner::run_tune(argv[2], *settings);
+            return 0;
+        } else if (std::string(argv[1]) == "datagen") {
+            if (argc < 3) {
+                std::cout << "usage: datagen <output> [positions] [threads] [nodes]\n";
+                return 1;
             }
+            const uint64_t positions = (argc > 3) ? std::stoull(argv[3]) : 1000000;
+            const int threads = (argc > 4) ? std::stoi(argv[4]) : std::thread::hardware_concurrency();
+            const uint64_t nodes = (argc > 5) ? std::stoull(argv[5]) : 5000;
+            Datagen::run_datagen(argv[2], positions, threads, nodes);
+            return 0;
+        } else if (std::string(argv[1]) == "spsa") {
+            if (argc < 3) {
+                std::cout << "usage: spsa <IS_TUNE engine> [iterations] [concurrency] [nodes] [book] [checkpoint]\n";
+                return 1;
+            }
+            Spsa::Settings settings;
+            settings.iterations = (argc > 3) ? std::stoi(argv[3]) : settings.iterations;
+            settings.concurrency = (argc > 4) ? std::stoi(argv[4]) : std::thread::hardware_concurrency();
+            settings.nodes = (argc > 5) ? std::stoull(argv[5]) : settings.nodes;
+            settings.book = (argc > 6) ? argv[6] : settings.book;
+            settings.checkpoint = (argc > 7) ? argv[7] : settings.checkpoint;
+            Spsa::run_spsa(argv[2], settings);
+            return 0;
+        } else if (std::string(argv[1]) == "analyze") {
+            const auto settings = (argc > 2) ? Analyze::parse_args(std::vector<std::string>(argv + 3, argv + argc)) : std::nullopt;
+            if (!settings.has_value()) {
+                std::cout << "usage: analyze <epd file> [--depth N | --nodes N | --movetime ms] [--threads N] [--hash MB] [--shared-tt]\n";
+                return 1;
+            }
+            Analyze::run_analyze(argv[2], *settings);
+            return 0;
+        } else if (std::string(argv[1]) == "serve") {
+            if (argc < 3) {
+                std::cout << "usage: serve <socket path> [workers] [hash]\n";
+                return 1;
+            }
+            Server::Settings settings;
+            settings.socket_path = argv[2];
+            settings.workers = (argc > 3) ? std::stoi(argv[3]) : std::thread::hardware_concurrency();
+            settings.hash_mb = (argc > 4) ? std::stoull(argv[4]) : settings.hash_mb;
+            settings.move_overhead_ms = uci_options()["Move Overhead"];
+            return Server::run_server(settings);
+        } else if (std::string(argv[1]) == "trace") {
+            if (argc < 3) {
+                std::cout << "usage: trace <trace file> [root move] [plies]\n";
+                return 1;
+            }
+            return TraceReader::print_tree(argv[2], (argc > 3) ? argv[3] : "", (argc > 4) ? std::stoi(argv[4]) : 2);
+        } else if (std::string(argv[1]) == "match") {
+            if (argc < 4) {
+                std::cout << "usage: match <first engine> <second engine> [games=N] [concurrency=N] [tc=seconds+increment] [nodes=N] "
+                             "[book=path] [sprt=elo0,elo1]\n";
+                return 1;
+            }
+            Match::Settings settings;
+            settings.limits = {0, 10000, 100};
+            settings.concurrency = std::thread::hardware_concurrency();
+            for (int i = 4; i < argc; i++) {
+                const std::string arg = argv[i];
+                const auto separator = arg.find('=');
+                const auto key = arg.substr(0, separator), value = (separator == std::string::npos) ? "" : arg.substr(separator + 1);
+                if (key == "games") {
+                    settings.games = std::stoull(value);
+                } else if (key == "concurrency") {
+                    settings.concurrency = std::stoi(value);
+                } else if (key == "tc") {
+                    const auto plus = value.find('+');
+                    settings.limits = {0, static_cast<uint32_t>(std::stod(value.substr(0, plus)) * 1000),
+                                       static_cast<uint32_t>((plus == std::string::npos) ? 0 : std::stod(value.substr(plus + 1)) * 1000)};
+                } else if (key == "nodes") {
+                    settings.limits = {std::stoull(value), 0, 0};
+                } else if (key == "book") {
+                    settings.book = value;
+                } else if (key == "sprt") {
+                    settings.sprt = true;
+                    settings.elo0 = std::stod(value.substr(0, value.find(',')));
+                    settings.elo1 = std::stod(value.substr(value.find(',') + 1));
+                }
+            }
+            Match::run_match(argv[2], argv[3], settings);
             return 0;
         }
     }
 
-    for (std::string line; std::getline(std::cin, line);) {
+    UciInput input(STDIN_FILENO, uci_output(), [&s] { s.EndSearch(); });
+    while (const auto next_line = input.next_line()) {
+        const auto& line = *next_line;
         if (line == "uci") {
-            std::cout << "id name Chessatron\n";
+            uci_output().write_line("id name Chessatron");
             for (const auto& element : uci_options()) {
-                std::cout << "option name " << element.first << element.second << std::endl;
+                std::ostringstream option;
+                option << "option name " << element.first << element.second;
+                uci_output().write_line(option.str());
             }
-            std::cout << "uciok" << std::endl;
+            uci_output().send("uciok");
         } else if (line == "isready") {
-            std::cout << "readyok\n";
+            uci_output().send("readyok");
         } else if (line == "ucinewgame") {
             s.reset();
         } else if (line == "quit") {
@@ -173,7 +222,9 @@ int main(int argc, char** argv) {
                 if (parsed_line[0] == std::string("go")) {
                     process_go_command(parsed_line, s);
                 } else if (parsed_line[0] == "position") {
-                    process_position_command(line, s);
+                    if (!process_position_command(line, s)) {
+                        uci_output().send("info string error: invalid position command");
+                    }
                 } else if (parsed_line[0] == "setoption") {
                     std::istringstream iss(line);
                     std::string token, value, option_name;
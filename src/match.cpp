@@ -0,0 +1,288 @@
+#include "match.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#include "move_generator.hpp"
+#include "search.hpp"
+
+constexpr int match_max_plies = 500;
+// how long to wait for a bestmove from a node-limited search before treating the engine as having crashed
+constexpr int match_node_search_timeout_ms = 60000;
+// how far an engine can overrun its clock before it loses on time, to allow for the latency of the pipes
+constexpr int match_time_margin_ms = 100;
+constexpr int match_random_opening_plies = 8;
+
+constexpr auto startpos_fen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+std::optional<Move> find_legal_move(const Position& pos, const std::string& move_string) {
+    const auto moves = MoveGenerator::generate_legal_moves<MoveGenType::ALL_LEGAL>(pos, pos.stm());
+    for (size_t i = 0; i < moves.size(); i++) {
+        if (moves[i].move.to_string() == move_string) {
+            return moves[i].move;
+        }
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief Plays random legal moves from the starting position, stopping early if the game ends
+ */
+Match::Opening Match::random_opening(std::mt19937_64& rng, int plies) {
+    Opening opening = {startpos_fen, {}};
+    Position pos;
+    pos.set_from_fen(opening.fen);
+    for (int i = 0; i < plies; i++) {
+        const auto moves = MoveGenerator::generate_legal_moves<MoveGenType::ALL_LEGAL>(pos, pos.stm());
+        if (moves.size() == 0) {
+            break;
+        }
+        const auto move = moves[rng() % moves.size()].move;
+        opening.moves.push_back(move.to_string());
+        pos = Position(pos, move);
+    }
+    return opening;
+}
+
+/**
+ * @brief Reads one opening per line from an EPD or FEN file.  Only the first four fields of each line are used
+ */
+std::vector<Match::Opening> Match::load_openings(const std::string& path) {
+    std::vector<Opening> openings;
+    std::ifstream file(path);
+    Position pos;
+    for (std::string line; std::getline(file, line);) {
+        std::istringstream fields(line);
+        std::string fen, field;
+        for (int i = 0; i < 4 && fields >> field; i++) {
+            fen += field + " ";
+        }
+        fen += "0 1";
+        if (pos.set_from_fen(fen).has_value()) {
+            openings.push_back({fen, {}});
+        }
+    }
+    return openings;
+}
+
+/**
+ * @brief Plays a single game, with this process acting as the arbiter.  An engine that crashes, stops responding or plays an illegal
+ * move loses the game
+ */
+Match::GameResult Match::play_game(UciEngine& white, UciEngine& black, const Opening& opening, const SearchLimits& limits) {
+    for (auto engine : {&white, &black}) {
+        engine->send("ucinewgame");
+        engine->is_ready();
+    }
+
+    Position start;
+    start.set_from_fen(opening.fen);
+    BoardHistory history(start);
+    std::string position_command = "position fen " + opening.fen + " moves";
+    for (const auto& move_string : opening.moves) {
+        const auto move = find_legal_move(history[history.len() - 1], move_string);
+        if (!move.has_value()) {
+            break;
+        }
+        history[history.len() - 1].make_move(*move, history);
+        position_command += " " + move_string;
+    }
+
+    const auto loss_for = [](Side side) { return side == Side::WHITE ? GameResult::BLACK_WIN : GameResult::WHITE_WIN; };
+    std::array<int64_t, 2> clocks = {limits.base_time_ms, limits.base_time_ms};
+    for (int ply = 0; ply < match_max_plies; ply++) {
+        const auto& pos = history[history.len() - 1];
+        const auto moves = MoveGenerator::generate_legal_moves<MoveGenType::ALL_LEGAL>(pos, pos.stm());
+        if (moves.size() == 0) {
+            return pos.in_check() ? loss_for(pos.stm()) : GameResult::DRAW;
+        }
+        if (Search::is_draw(pos, history)) {
+            return GameResult::DRAW;
+        }
+
+        auto& engine = (pos.stm() == Side::WHITE) ? white : black;
+        engine.send(position_command);
+        auto& clock = clocks[static_cast<int>(pos.stm())];
+        const auto search_start = std::chrono::steady_clock::now();
+        std::optional<std::string> response;
+        if (limits.nodes != 0) {
+            engine.send("go nodes " + std::to_string(limits.nodes));
+            response = engine.wait_for("bestmove", match_node_search_timeout_ms);
+        } else {
+            engine.send("go wtime " + std::to_string(clocks[0]) + " btime " + std::to_string(clocks[1]) + " winc " +
+                        std::to_string(limits.increment_ms) + " binc " + std::to_string(limits.increment_ms));
+            response = engine.wait_for("bestmove", clock + match_time_margin_ms);
+            clock -= std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - search_start).count();
+            if (response.has_value() && clock < -match_time_margin_ms) {
+                // the bestmove came too late, but it has come, so there's no search left to stop
+                return loss_for(pos.stm());
+            }
+            clock = std::max(clock, static_cast<int64_t>(0)) + limits.increment_ms;
+        }
+        if (!response.has_value()) {
+            // stop the search so its bestmove isn't mistaken for a reply in the next game
+            engine.send("stop");
+            engine.wait_for("bestmove", 1000);
+            return loss_for(pos.stm());
+        }
+        std::istringstream tokens(*response);
+        std::string token, move_string;
+        tokens >> token >> move_string;
+        const auto move = find_legal_move(pos, move_string);
+        if (!move.has_value()) {
+            return loss_for(pos.stm());
+        }
+        pos.make_move(*move, history);
+        position_command += " " + move_string;
+    }
+    return GameResult::DRAW;
+}
+
+double Match::Stats::score() const { return games() == 0 ? 0.5 : (wins + draws / 2.0) / games(); }
+
+double Match::Stats::variance() const {
+    if (games() == 0) {
+        return 0;
+    }
+    const auto s = score();
+    return (wins * (1 - s) * (1 - s) + draws * (0.5 - s) * (0.5 - s) + losses * s * s) / games();
+}
+
+double elo_from_score(double score) {
+    score = std::clamp(score, 1e-6, 1 - 1e-6);
+    return -400 * std::log10(1 / score - 1);
+}
+
+double score_from_elo(double elo) { return 1 / (1 + std::pow(10, -elo / 400)); }
+
+double Match::Stats::elo() const { return elo_from_score(score()); }
+
+/**
+ * @brief Half the width of the 95% confidence interval of the Elo difference
+ */
+double Match::Stats::elo_error() const {
+    if (games() == 0) {
+        return 0;
+    }
+    const auto deviation = 1.959964 * std::sqrt(variance() / games());
+    return (elo_from_score(score() + deviation) - elo_from_score(score() - deviation)) / 2;
+}
+
+/**
+ * @brief The log-likelihood ratio of elo1 over elo0 under the normalized GSPRT approximation, which treats the mean score as normally
+ * distributed: LLR = N * (s1 - s0) * (2 * s - s0 - s1) / (2 * var), with s0 and s1 the scores expected at elo0 and elo1, s the observed
+ * score and var the per-game variance of the trinomial results
+ */
+double Match::Stats::llr(double elo0, double elo1) const {
+    const auto var = variance();
+    if (games() == 0 || var == 0) {
+        return 0;
+    }
+    const auto s0 = score_from_elo(elo0);
+    const auto s1 = score_from_elo(elo1);
+    return games() * (s1 - s0) * (2 * score() - s0 - s1) / (2 * var);
+}
+
+struct MatchState {
+    std::vector<Match::Opening> book;
+    Match::Stats stats;
+    std::mutex mutex;
+    std::atomic<uint64_t> next_pair = 0;
+    std::atomic<bool> finished = false;
+    std::chrono::steady_clock::time_point start;
+};
+
+void print_match_status(const MatchState& state, const Match::Settings& settings) {
+    const auto& stats = state.stats;
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - state.start).count();
+    printf("games %lu: +%lu =%lu -%lu, elo %.1f +/- %.1f", stats.games(), stats.wins, stats.draws, stats.losses, stats.elo(),
+           stats.elo_error());
+    if (settings.sprt) {
+        printf(", llr %.2f (%.2f, %.2f)", stats.llr(settings.elo0, settings.elo1), std::log(settings.beta / (1 - settings.alpha)),
+               std::log((1 - settings.beta) / settings.alpha));
+    }
+    printf(" [%.0fs]\n", elapsed);
+    fflush(stdout);
+}
+
+/**
+ * @brief Plays game pairs until the match is over.  Both games of a pair start from the same opening with the colours reversed, so
+ * that an unbalanced opening can't favour either engine
+ */
+void run_match_worker(MatchState& state, const std::string& first_engine, const std::string& second_engine, const Match::Settings& settings,
+                      uint64_t seed) {
+    UciEngine first(first_engine), second(second_engine);
+    for (auto engine : {&first, &second}) {
+        engine->send("uci");
+        engine->wait_for("uciok", 10000);
+    }
+    std::mt19937_64 rng(seed);
+    const auto pairs = (settings.games + 1) / 2;
+    for (uint64_t pair; !state.finished && (pair = state.next_pair++) < pairs;) {
+        const auto opening =
+            state.book.empty() ? Match::random_opening(rng, match_random_opening_plies) : state.book[pair % state.book.size()];
+        const auto first_white = Match::play_game(first, second, opening, settings.limits);
+        const auto first_black = Match::play_game(second, first, opening, settings.limits);
+
+        std::lock_guard<std::mutex> lock(state.mutex);
+        for (const auto& [result, first_is_white] : {std::make_pair(first_white, true), std::make_pair(first_black, false)}) {
+            if (result == Match::GameResult::DRAW) {
+                state.stats.draws += 1;
+            } else if ((result == Match::GameResult::WHITE_WIN) == first_is_white) {
+                state.stats.wins += 1;
+            } else {
+                state.stats.losses += 1;
+            }
+        }
+        print_match_status(state, settings);
+        if (settings.sprt) {
+            const auto llr = state.stats.llr(settings.elo0, settings.elo1);
+            if (llr <= std::log(settings.beta / (1 - settings.alpha)) || llr >= std::log((1 - settings.beta) / settings.alpha)) {
+                state.finished = true;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Plays a match between two engines with one game pair in flight per thread, reporting the Elo difference after every pair
+ * and stopping early once the SPRT, if enabled, reaches a decision
+ */
+void Match::run_match(const std::string& first_engine, const std::string& second_engine, const Settings& settings) {
+    MatchState state;
+    if (!settings.book.empty()) {
+        state.book = load_openings(settings.book);
+        // start from a random point in the book so that repeated matches don't replay the same openings
+        std::shuffle(state.book.begin(), state.book.end(), std::mt19937_64(std::random_device()()));
+        printf("loaded %zu openings from %s\n", state.book.size(), settings.book.c_str());
+    }
+    state.start = std::chrono::steady_clock::now();
+
+    std::random_device random_device;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < std::max(settings.concurrency, 1); i++) {
+        threads.emplace_back(run_match_worker, std::ref(state), std::cref(first_engine), std::cref(second_engine), std::cref(settings),
+                             (static_cast<uint64_t>(random_device()) << 32) | random_device());
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    printf("final result: ");
+    print_match_status(state, settings);
+    if (settings.sprt) {
+        const auto llr = state.stats.llr(settings.elo0, settings.elo1);
+        printf("sprt [%.1f, %.1f]: %s\n", settings.elo0, settings.elo1,
+               llr >= std::log((1 - settings.beta) / settings.alpha) ? "H1 accepted"
+               : llr <= std::log(settings.beta / (1 - settings.alpha)) ? "H0 accepted"
+                                                                         : "inconclusive");
+    }
+}
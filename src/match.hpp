@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "uci_engine.hpp"
+
+namespace Match {
+    /**
+     * @brief A starting position for a game, given as a FEN followed by any moves made from it
+     */
+    struct Opening {
+        std::string fen;
+        std::vector<std::string> moves;
+    };
+
+    /**
+     * @brief Either a node limit per move, or a clock for each side that starts at base_time_ms and gains increment_ms per move
+     */
+    struct SearchLimits {
+        uint64_t nodes = 0;
+        uint32_t base_time_ms = 0;
+        uint32_t increment_ms = 0;
+    };
+
+    enum class GameResult {
+        WHITE_WIN,
+        DRAW,
+        BLACK_WIN,
+    };
+
+    /**
+     * @brief Results from the first engine's perspective
+     */
+    struct Stats {
+        uint64_t wins = 0;
+        uint64_t draws = 0;
+        uint64_t losses = 0;
+
+        uint64_t games() const { return wins + draws + losses; };
+        double score() const;
+        double variance() const;
+        double elo() const;
+        double elo_error() const;
+        double llr(double elo0, double elo1) const;
+    };
+
+    struct Settings {
+        SearchLimits limits;
+        uint64_t games = 100;
+        int concurrency = 1;
+        std::string book;
+        bool sprt = false;
+        double elo0 = 0;
+        double elo1 = 5;
+        double alpha = 0.05;
+        double beta = 0.05;
+    };
+
+    Opening random_opening(std::mt19937_64& rng, int plies);
+    std::vector<Opening> load_openings(const std::string& path);
+    GameResult play_game(UciEngine& white, UciEngine& black, const Opening& opening, const SearchLimits& limits);
+    void run_match(const std::string& first_engine, const std::string& second_engine, const Settings& settings);
+} // namespace Match
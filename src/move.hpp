@@ -1,8 +1,11 @@
 #pragma once
 
 #include <array>
+#include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <limits>
 #include <string>
 
 #include "pieces.hpp"
@@ -68,8 +71,9 @@ class Move {
 struct ScoredMove {
     int32_t score;
     Move move;
-    bool see_ordering_result;
-    uint8_t padding;
+    Score see_value;
+
+    static constexpr Score UnknownSee = std::numeric_limits<Score>::min();
 
     ScoredMove() {};
     ScoredMove(Move move) : move(move) {};
@@ -96,6 +100,13 @@ class StackVector {
 
         size_t size() const { return this->idx; };
 
+        // Used by bulk writers that fill the elements past the end themselves and then claim them
+        T* end_ptr() { return data.data() + idx; };
+        void grow(size_t count) {
+            assert(idx + count <= elem_count);
+            idx += count;
+        };
+
         auto begin() const { return data.begin(); };
         auto begin() { return data.begin(); };
         auto end() const { return data.begin() + idx; };
@@ -104,5 +115,9 @@ class StackVector {
         void clear() { this->idx = 0; };
 };
 
+static_assert(sizeof(ScoredMove) == 8);
+static_assert(offsetof(ScoredMove, move) == 4);
+// The SIMD move serialisation in move_generator.hpp relies on this layout
+
 using MoveList = StackVector<ScoredMove, MAX_TURN_MOVE_COUNT>;
 using UnscoredMoveList = StackVector<Move, MAX_TURN_MOVE_COUNT>;
\ No newline at end of file
@@ -41,13 +41,13 @@ Bitboard MoveGenerator::get_attackers(const Position& board, const Side side, co
 Bitboard MoveGenerator::generate_bishop_mm(const Bitboard b, const Square sq) {
     const auto idx = sq_to_int(sq);
     Bitboard masked = (b & MagicNumbers::BishopMasks[idx]);
-    return MagicNumbers::BishopAttacks[idx][((masked * MagicNumbers::BishopMagics[idx]) >> (64 - MagicNumbers::BishopBits[idx]))];
+    return MagicNumbers::SliderAttacks[MagicNumbers::BishopOffsets[idx] + ((masked * MagicNumbers::BishopMagics[idx]) >> (64 - MagicNumbers::BishopBits[idx]))];
 }
 
 Bitboard MoveGenerator::generate_rook_mm(const Bitboard b, const Square sq) {
     const auto idx = sq_to_int(sq);
     Bitboard masked = (b & MagicNumbers::RookMasks[idx]);
-    return MagicNumbers::RookAttacks[idx][((masked * MagicNumbers::RookMagics[idx]) >> (64 - MagicNumbers::RookBits[idx]))];
+    return MagicNumbers::SliderAttacks[MagicNumbers::RookOffsets[idx] + ((masked * MagicNumbers::RookMagics[idx]) >> (64 - MagicNumbers::RookBits[idx]))];
 }
 
 Bitboard MoveGenerator::generate_queen_mm(const Bitboard b, const Square sq) {
@@ -147,6 +147,70 @@ bool MoveGenerator::is_move_legal(const Position& c, const Move m) {
     return true;
 }
 
+/**
+ * @brief Checks whether the side to move has any legal move, stopping at the first one found.  King moves are tried first as they are the
+ * only moves out of a double check and are rarely all blocked, then the other pieces from the most to the least mobile, with pawns last as
+ * they need the full pawn move generation.  Castling never needs to be checked, since castling is only legal when the king can also step
+ * onto the square next to it
+ *
+ * @param pos
+ * @return true
+ * @return false
+ */
+bool MoveGenerator::has_legal_move(const Position& pos) {
+    const auto stm = pos.stm();
+    const auto enemy = enemy_side(stm);
+    const auto ksq = pos.kings(stm).lsb();
+    const auto friendly = pos.occupancy(stm);
+    const auto cleared = pos.occupancy() ^ ksq;
+    auto king_targets = MagicNumbers::KingMoves[sq_to_int(ksq)] & ~friendly;
+    while (!king_targets.empty()) {
+        if (get_attackers(pos, enemy, king_targets.pop_lsb(), cleared).empty()) {
+            return true;
+        }
+    }
+
+    const auto checker_count = pos.checkers().popcnt();
+    if (checker_count >= 2) {
+        return false;
+    }
+    MoveList moves;
+    if (checker_count == 1) {
+        if (stm == Side::WHITE) {
+            generate_evasions<MoveGenType::ALL_LEGAL, Side::WHITE>(pos, moves);
+        } else {
+            generate_evasions<MoveGenType::ALL_LEGAL, Side::BLACK>(pos, moves);
+        }
+        return moves.size() > 0;
+    }
+
+    const auto occupied = pos.occupancy();
+    const auto has_target = [&](PieceTypes piece_type, Bitboard pieces) {
+        while (!pieces.empty()) {
+            const auto sq = pieces.pop_lsb();
+            auto targets = generate_mm(piece_type, occupied, sq) & ~friendly;
+            if (!(pos.pinned_pieces() & sq).empty()) {
+                targets &= MagicNumbers::AlignedSquares[sq_to_int(ksq)][sq_to_int(sq)];
+            }
+            if (!targets.empty()) {
+                return true;
+            }
+        }
+        return false;
+    };
+    if (has_target(PieceTypes::QUEEN, pos.queens(stm)) || has_target(PieceTypes::ROOK, pos.rooks(stm))
+        || has_target(PieceTypes::BISHOP, pos.bishops(stm)) || has_target(PieceTypes::KNIGHT, pos.knights(stm))) {
+        return true;
+    }
+
+    if (stm == Side::WHITE) {
+        generate_pawn_moves<MoveGenType::ALL_LEGAL, Side::WHITE>(pos, moves);
+    } else {
+        generate_pawn_moves<MoveGenType::ALL_LEGAL, Side::BLACK>(pos, moves);
+    }
+    return moves.size() > 0;
+}
+
 /**
  * @brief Checks if a move on a position is pseudolegal; algorithm stolen from Stockfish
  * 
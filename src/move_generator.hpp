@@ -3,6 +3,9 @@
 #include <cstdint>
 #include <iostream>
 
+#if defined(__AVX512VBMI2__)
+#include <immintrin.h>
+#endif
 
 #include "chessboard.hpp"
 #include "move.hpp"
@@ -33,10 +36,12 @@ namespace MoveGenerator {
 
     template <PieceTypes piece_type, MoveGenType gen_type> void generate_moves(const Position& c, const Side side, MoveList& move_list);
     template <MoveGenType gen_type, Side stm> void generate_pawn_moves(const Position& c, MoveList& move_list);
+    template <MoveGenType gen_type, Side stm> void generate_evasions(const Position& c, MoveList& move_list);
     void generate_castling_moves(const Position& c, const Side side, MoveList& move_list);
 
     bool is_move_legal(const Position& c, const Move m);
     bool is_move_pseudolegal(const Position& c, const Move to_test);
+    bool has_legal_move(const Position& pos);
 
     template <MoveGenType gen_type> MoveList generate_legal_moves(const Position& c, const Side side);
 } // namespace MoveGenerator
@@ -50,6 +55,13 @@ template <MoveGenType gen_type> MoveList MoveGenerator::generate_legal_moves(con
 
     if (checking_piece_count >= 2) {
         return to_return;
+    } else if (checking_piece_count == 1) {
+        if (side == Side::WHITE) {
+            MoveGenerator::generate_evasions<gen_type, Side::WHITE>(c, to_return);
+        } else {
+            MoveGenerator::generate_evasions<gen_type, Side::BLACK>(c, to_return);
+        }
+        return to_return;
     }
 
     if (gen_quiets(gen_type) && checking_piece_count == 0) {
@@ -95,6 +107,60 @@ inline Bitboard MoveGenerator::generate_mm<PieceTypes::KING>(const Bitboard b, c
     return MagicNumbers::KingMoves[sq_to_int(sq)];
 }
 
+/**
+ * @brief Appends a move to the list for every set bit of targets, in ascending square order.  Moves landing on a square in captures have the
+ * capture flag added to the base flags.  If relative_src is set the source square is the destination minus src, otherwise src is the source
+ * square itself.  With AVX-512 VBMI2 the destinations are compressed out of the bitboard and eight moves are written per store
+ *
+ * @tparam relative_src
+ * @param move_list
+ * @param targets
+ * @param captures
+ * @param src
+ * @param flags
+ */
+template <bool relative_src> inline void serialise_moves(MoveList& move_list, Bitboard targets, const Bitboard captures, const int src, const MoveFlags flags) {
+#if defined(__AVX512VBMI2__)
+    const auto count = targets.popcnt();
+    if (count < 8) {
+        // Most calls only produce a handful of moves, where setting up the vectors costs more than it saves
+        while (!targets.empty()) {
+            const auto dst = targets.pop_lsb();
+            const auto flag = captures[dst] ? (flags | MoveFlags::CAPTURE) : flags;
+            move_list.add(Move(flag, dst, relative_src ? dst - src : static_cast<Square>(src)));
+        }
+        return;
+    }
+    alignas(64) std::array<uint8_t, 64> dsts;
+    const __m512i squares = _mm512_set_epi8(63, 62, 61, 60, 59, 58, 57, 56, 55, 54, 53, 52, 51, 50, 49, 48, 47, 46, 45, 44, 43, 42, 41, 40, 39,
+                                            38, 37, 36, 35, 34, 33, 32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16, 15, 14,
+                                            13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    _mm512_store_si512(dsts.data(), _mm512_maskz_compress_epi8(targets.bb, squares));
+    // bit i of capture_bits is set if the ith target is a capture
+    const uint64_t capture_bits = _pext_u64(captures.bb, targets.bb);
+    const __m512i base = _mm512_set1_epi64((static_cast<uint64_t>(flags) << 12) | (relative_src ? 0 : src));
+    const __m512i capture_flag = _mm512_set1_epi64(static_cast<uint64_t>(MoveFlags::CAPTURE) << 12);
+    const auto output = reinterpret_cast<long long*>(move_list.end_ptr());
+    for (int i = 0; i < count; i += 8) {
+        const __m512i dst = _mm512_cvtepu8_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(dsts.data() + i)));
+        __m512i moves = _mm512_or_si512(_mm512_slli_epi64(dst, 6), base);
+        if constexpr (relative_src) {
+            moves = _mm512_or_si512(moves, _mm512_sub_epi64(dst, _mm512_set1_epi64(src)));
+        }
+        moves = _mm512_mask_or_epi64(moves, static_cast<__mmask8>(capture_bits >> i), moves, capture_flag);
+        // The move sits in the upper half of each ScoredMove, above the score
+        _mm512_mask_storeu_epi64(output + i, static_cast<__mmask8>(_bzhi_u32(0xFF, count - i)), _mm512_slli_epi64(moves, 32));
+    }
+    move_list.grow(count);
+#else
+    while (!targets.empty()) {
+        const auto dst = targets.pop_lsb();
+        const auto flag = captures[dst] ? (flags | MoveFlags::CAPTURE) : flags;
+        move_list.add(Move(flag, dst, relative_src ? dst - src : static_cast<Square>(src)));
+    }
+#endif
+}
+
 template <PieceTypes piece_type, MoveGenType gen_type> void MoveGenerator::generate_moves(const Position& c, const Side stm, MoveList& output) {
     if constexpr (piece_type == PieceTypes::PAWN) {
         return generate_pawn_moves<gen_type>(c, stm, output);
@@ -125,19 +191,18 @@ template <PieceTypes piece_type, MoveGenType gen_type> void MoveGenerator::gener
             // these are the only valid move positions
         }
 
-        while (!potential_moves.empty()) {
-            const auto target_idx = potential_moves.pop_lsb();
-            if constexpr (piece_type == PieceTypes::KING) {
-                const Bitboard cleared_bb = all_bb ^ king_idx;
+        if constexpr (piece_type == PieceTypes::KING) {
+            const Bitboard cleared_bb = all_bb ^ king_idx;
+            Bitboard to_check = potential_moves;
+            while (!to_check.empty()) {
+                const auto target_idx = to_check.pop_lsb();
                 if (!get_attackers(c, enemy, target_idx, cleared_bb).empty()) {
-                    continue;
+                    potential_moves ^= target_idx;
                 }
             }
-            const auto flag = (c.occupancy()[target_idx])
-                ? MoveFlags::CAPTURE
-                : MoveFlags::QUIET_MOVE;
-            output.add(Move(flag, target_idx, piece_idx));
         }
+
+        serialise_moves<false>(output, potential_moves, potential_moves & enemy_bb, sq_to_int(piece_idx), MoveFlags::QUIET_MOVE);
     }
 }
 
@@ -148,6 +213,43 @@ template <MoveGenType gen_type, MoveFlags base_flags> void gen_promotions(MoveLi
     move_list.add(Move(MoveFlags::BISHOP_PROMOTION | base_flags, dst, src));
 }
 
+template <Side stm> void gen_pawn_captures(MoveList& move_list, const Bitboard targets, const int offset) {
+    constexpr auto back_rank_bb = rank_bb(stm == Side::WHITE ? 7 : 0);
+    auto promoting = targets & back_rank_bb;
+    // Promotions are on the highest squares for white and the lowest for black, so this keeps the moves in ascending square order
+    if constexpr (stm == Side::WHITE) {
+        serialise_moves<true>(move_list, targets & ~back_rank_bb, 0, offset, MoveFlags::CAPTURE);
+    }
+    while (!promoting.empty()) {
+        const auto lsb = promoting.pop_lsb();
+        gen_promotions<MoveGenType::ALL_LEGAL, MoveFlags::CAPTURE>(move_list, lsb - offset, lsb);
+    }
+    if constexpr (stm == Side::BLACK) {
+        serialise_moves<true>(move_list, targets & ~back_rank_bb, 0, offset, MoveFlags::CAPTURE);
+    }
+}
+
+template <Side stm> void gen_en_passant(const Position& c, MoveList& move_list) {
+    const auto ksq = c.kings(stm).lsb();
+    constexpr std::array<Bitboard, 10> ep_masks { 0x202020202020202, 0x505050505050505, 0xa0a0a0a0a0a0a0a, 0x1414141414141414, 0x2828282828282828, 0x5050505050505050, 0xa0a0a0a0a0a0a0a0, 0x4040404040404040, 0, 0 };
+    constexpr Bitboard ep_rank_mask = stm == Side::WHITE ? rank_bb(4) : rank_bb(3);
+    auto ep_pawns = ep_masks[c.get_en_passant_file()] & ep_rank_mask & c.pawns(stm);
+    while (!ep_pawns.empty()) {
+        const auto lsb = ep_pawns.pop_lsb();
+        constexpr auto ep_offset = stm == Side::WHITE ? 1 : -1;
+        const auto ep_target_square = get_position((stm == Side::WHITE ? 4 : 3) + ep_offset, c.get_en_passant_file());
+        const auto cleared_bb = c.occupancy() ^ lsb ^ ep_target_square ^ (ep_target_square - (8 * ep_offset));
+        const Bitboard threatening_bishops =
+            MoveGenerator::generate_bishop_mm(cleared_bb, ksq) & (c.bishops(enemy_side(stm)) | c.queens(enemy_side(stm)));
+        const Bitboard threatening_rooks =
+            MoveGenerator::generate_rook_mm(cleared_bb, ksq) & (c.rooks(enemy_side(stm)) | c.queens(enemy_side(stm)));
+
+        if (threatening_bishops.empty() && threatening_rooks.empty()) {
+            move_list.add(Move(MoveFlags::EN_PASSANT_CAPTURE, ep_target_square, lsb));
+        }
+    }
+}
+
 template <MoveGenType gen_type, Side stm> void MoveGenerator::generate_pawn_moves(const Position& c, MoveList& move_list) {
     const auto friendly_pawns = c.pawns(stm);
     const auto occupied = c.occupancy();
@@ -167,10 +269,7 @@ template <MoveGenType gen_type, Side stm> void MoveGenerator::generate_pawn_move
         auto double_advancing = (stm == Side::WHITE ? advancing << 8 : advancing >> 8) & ~occupied & valid_dests;
         double_advancing &= rank_bb(stm == Side::WHITE ? 3 : 4);
 
-        while (!double_advancing.empty()) {
-            const auto lsb = double_advancing.pop_lsb();
-            move_list.add(Move(MoveFlags::DOUBLE_PAWN_PUSH, lsb, lsb - (2 * ahead)));
-        }
+        serialise_moves<true>(move_list, double_advancing, 0, 2 * ahead, MoveFlags::DOUBLE_PAWN_PUSH);
     }
 
     // promotions can be generated both within and outside 
@@ -185,10 +284,7 @@ template <MoveGenType gen_type, Side stm> void MoveGenerator::generate_pawn_move
     }
 
     if constexpr (gen_quiets(gen_type)) {
-        while (!non_promotable.empty()) {
-            const auto lsb = non_promotable.pop_lsb();
-            move_list.add(Move(MoveFlags::QUIET_MOVE, lsb, lsb - ahead));
-        }
+        serialise_moves<true>(move_list, non_promotable, 0, ahead, MoveFlags::QUIET_MOVE);
     }
 
     if constexpr (gen_noisies(gen_type)) {
@@ -203,14 +299,7 @@ template <MoveGenType gen_type, Side stm> void MoveGenerator::generate_pawn_move
                 return pinned_pawns & MagicNumbers::AlignedSquares[sq_to_int(ksq)][sq_to_int(ksq + offset)];
             }() | unpinned_pawns) & ~a_file;
             capturing_pieces = (stm == Side::WHITE ? capturing_pieces << 7 : capturing_pieces >> 9) & enemy_bb & valid_dests;
-            while (!capturing_pieces.empty()) {
-                const auto lsb = capturing_pieces.pop_lsb();
-                if (rank(lsb) == back_rank) {
-                    gen_promotions<MoveGenType::ALL_LEGAL, MoveFlags::CAPTURE>(move_list, lsb - offset, lsb);
-                } else {
-                    move_list.add(Move(MoveFlags::CAPTURE, lsb, lsb - offset));
-                }
-            }
+            gen_pawn_captures<stm>(move_list, capturing_pieces, offset);
         }
         {
             // towards h file
@@ -222,32 +311,73 @@ template <MoveGenType gen_type, Side stm> void MoveGenerator::generate_pawn_move
                 return pinned_pawns & MagicNumbers::AlignedSquares[sq_to_int(ksq)][sq_to_int(ksq + offset)];
             }() | unpinned_pawns) & ~h_file;
             capturing_pieces = (stm == Side::WHITE ? capturing_pieces << 9 : capturing_pieces >> 7) & enemy_bb & valid_dests;
-            while (!capturing_pieces.empty()) {
-                const auto lsb = capturing_pieces.pop_lsb();
-                if (rank(lsb) == back_rank) {
-                    gen_promotions<MoveGenType::ALL_LEGAL, MoveFlags::CAPTURE>(move_list, lsb - offset, lsb);
-                } else {
-                    move_list.add(Move(MoveFlags::CAPTURE, lsb, lsb - offset));
-                }
+            gen_pawn_captures<stm>(move_list, capturing_pieces, offset);
+        }
+
+        gen_en_passant<stm>(c, move_list);
+    }
+}
+
+/**
+ * @brief Generates the non-king moves that get out of a single check: captures of the checking piece and interpositions between it and the
+ * king.  Rather than generating every piece's moves and masking them, this works backwards from the few squares that resolve the check.
+ * Pinned pieces can never resolve a check, so they are skipped entirely
+ *
+ * @tparam gen_type
+ * @tparam stm
+ * @param c
+ * @param move_list
+ */
+template <MoveGenType gen_type, Side stm> void MoveGenerator::generate_evasions(const Position& c, MoveList& move_list) {
+    constexpr auto ahead = stm == Side::WHITE ? 8 : -8;
+    constexpr auto back_rank_bb = rank_bb(stm == Side::WHITE ? 7 : 0);
+    const auto ksq = c.kings(stm).lsb();
+    const auto checker = c.checkers().lsb();
+    const auto occupied = c.occupancy();
+    const auto movable = c.occupancy(stm) & ~c.pinned_pieces() & ~c.kings(stm);
+    const auto movable_pawns = movable & c.pawns(stm);
+    // ConnectingSquares includes the checking piece's square, which we can only capture on
+    const auto blocks = MagicNumbers::ConnectingSquares[sq_to_int(ksq)][sq_to_int(checker)] ^ checker;
+
+    if constexpr (gen_noisies(gen_type)) {
+        auto capturers = get_attackers(c, stm, checker, occupied) & movable;
+        while (!capturers.empty()) {
+            const auto src = capturers.pop_lsb();
+            if (c.pawns()[src] && back_rank_bb[checker]) {
+                gen_promotions<MoveGenType::ALL_LEGAL, MoveFlags::CAPTURE>(move_list, src, checker);
+            } else {
+                move_list.add(Move(MoveFlags::CAPTURE, checker, src));
             }
         }
+        gen_en_passant<stm>(c, move_list);
 
+        auto promoting_blocks = blocks & back_rank_bb & (stm == Side::WHITE ? movable_pawns << 8 : movable_pawns >> 8);
+        while (!promoting_blocks.empty()) {
+            const auto dst = promoting_blocks.pop_lsb();
+            gen_promotions<MoveGenType::ALL_LEGAL, MoveFlags::QUIET_MOVE>(move_list, dst - ahead, dst);
+        }
+    }
 
-        constexpr std::array<Bitboard, 10> ep_masks { 0x202020202020202, 0x505050505050505, 0xa0a0a0a0a0a0a0a, 0x1414141414141414, 0x2828282828282828, 0x5050505050505050, 0xa0a0a0a0a0a0a0a0, 0x4040404040404040, 0, 0 };
-        constexpr Bitboard ep_rank_mask = stm == Side::WHITE ? rank_bb(4) : rank_bb(3);
-        auto ep_pawns = ep_masks[c.get_en_passant_file()] & ep_rank_mask & c.pawns(stm);
-        while (!ep_pawns.empty()) {
-            const auto lsb = ep_pawns.pop_lsb();
-            constexpr auto ep_offset = stm == Side::WHITE ? 1 : -1;
-            const auto ep_target_square = get_position((stm == Side::WHITE ? 4 : 3) + ep_offset, c.get_en_passant_file());
-            const auto cleared_bb = occupied ^ lsb ^ ep_target_square ^ (ep_target_square - (8 * ep_offset));
-            const Bitboard threatening_bishops =
-                generate_bishop_mm(cleared_bb, ksq) & (c.bishops(enemy_side(stm)) | c.queens(enemy_side(stm)));
-            const Bitboard threatening_rooks =
-                generate_rook_mm(cleared_bb, ksq) & (c.rooks(enemy_side(stm)) | c.queens(enemy_side(stm)));
-
-            if (threatening_bishops.empty() && threatening_rooks.empty()) {
-                move_list.add(Move(MoveFlags::EN_PASSANT_CAPTURE, ep_target_square, lsb));
+    if constexpr (gen_quiets(gen_type)) {
+        const auto pushes = blocks & (stm == Side::WHITE ? movable_pawns << 8 : movable_pawns >> 8);
+        serialise_moves<true>(move_list, pushes & ~back_rank_bb, 0, ahead, MoveFlags::QUIET_MOVE);
+
+        constexpr auto double_push_rank = rank_bb(stm == Side::WHITE ? 3 : 4);
+        const auto single_pushes = (stm == Side::WHITE ? movable_pawns << 8 : movable_pawns >> 8) & ~occupied;
+        const auto double_pushes = blocks & double_push_rank & (stm == Side::WHITE ? single_pushes << 8 : single_pushes >> 8);
+        serialise_moves<true>(move_list, double_pushes, 0, 2 * ahead, MoveFlags::DOUBLE_PAWN_PUSH);
+
+        const auto diagonal_sliders = movable & (c.bishops(stm) | c.queens(stm));
+        const auto orthogonal_sliders = movable & (c.rooks(stm) | c.queens(stm));
+        const auto knights = movable & c.knights(stm);
+        auto to_block = blocks;
+        while (!to_block.empty()) {
+            const auto dst = to_block.pop_lsb();
+            auto blockers = (knights & MagicNumbers::KnightMoves[sq_to_int(dst)])
+                            | (diagonal_sliders & generate_bishop_mm(occupied, dst))
+                            | (orthogonal_sliders & generate_rook_mm(occupied, dst));
+            while (!blockers.empty()) {
+                move_list.add(Move(MoveFlags::QUIET_MOVE, dst, blockers.pop_lsb()));
             }
         }
     }
@@ -8,8 +8,10 @@
 #include "search.hpp"
 
 constexpr std::array<uint8_t, 6> ordering_scores = {1, 2, 3, 4, 5, 6};
+constexpr int32_t good_noisy_score = 900000000;
+constexpr int32_t bad_noisy_score = -1000000;
 
-MovePicker::MovePicker(MoveList&& input_moves, const Position& pos, const BoardHistory& hist, const Move pv_move, const HistoryTable& history_table, Move killer) {
+MovePicker::MovePicker(MoveList&& input_moves, const Position& pos, const SearchStackFrame& parent, const Move pv_move, const HistoryTable& history_table, Move killer) : pos(pos) {
     this->moves = input_moves;
     this->idx = 0;
 
@@ -18,32 +20,59 @@ MovePicker::MovePicker(MoveList&& input_moves, const Position& pos, const BoardH
     for (size_t i = 0; i < moves.size(); i++) {
         auto& move = moves[i];
         move.score = 0;
+        move.see_value = ScoredMove::UnknownSee;
         if (move.move == pv_move) {
             move.score = std::numeric_limits<int32_t>::max();
             //continue;
         } else if (move.move.is_noisy()) {
-            move.score = 900000000;
-            move.see_ordering_result = Search::static_exchange_evaluation(pos, move.move, -20);
-            if (!move.see_ordering_result) {
-                move.score = -1000000;
-            }
+            // every noisy move is assumed to pass SEE until it is reached, see resolve_see
+            move.score = good_noisy_score;
             const auto dest_type = (move.move.is_promotion() || move.move.flags() == MoveFlags::EN_PASSANT_CAPTURE)
                                        ? PieceTypes::PAWN
                                        : pos.piece_at(move.move.dst_sq()).type();
             const auto dest_score = ordering_scores[static_cast<uint8_t>(dest_type) - 1];
-            move.score += ((100000 * dest_score) + history_table.capthist_score(hist, move.move));
+            move.score += ((100000 * dest_score) + history_table.capthist_score(pos, move.move));
         } else if (move.move == killer) {
             move.score = 800000000;
         } else {
-            move.score += history_table.score(hist, move.move, pos.stm());
+            move.score += history_table.score(pos, parent, move.move);
         }
         if (move.score > moves[best_idx].score) {
             best_idx = i;
         }
     }
+    while (moves.size() > 0 && !resolve_see(moves[best_idx])) {
+        best_idx = 0;
+        for (size_t i = 1; i < moves.size(); i++) {
+            if (moves[i].score > moves[best_idx].score) {
+                best_idx = i;
+            }
+        }
+    }
     std::swap(moves[0], moves[best_idx]);
 }
 
+/**
+ * @brief Computes the SEE value of a noisy move the first time it's about to be returned, and moves it down into the losing captures if it
+ * fails the ordering threshold.  Most nodes cut off after a few moves, so most captures never need an exchange evaluation at all, and the
+ * exact value is kept with the move so the search's pruning can test it against other thresholds for free
+ *
+ * @param move
+ * @return true if the move keeps its place in the ordering
+ * @return false if it was demoted and a new best move must be selected
+ */
+bool MovePicker::resolve_see(ScoredMove& move) {
+    if (!move.move.is_noisy() || move.see_value != ScoredMove::UnknownSee) {
+        return true;
+    }
+    move.see_value = Search::static_exchange_value(pos, move.move);
+    if (move.see_value >= see_ordering_threshold || move.score == std::numeric_limits<int32_t>::max()) {
+        return true;
+    }
+    move.score += bad_noisy_score - good_noisy_score;
+    return false;
+}
+
 
 std::optional<ScoredMove> MovePicker::next(const bool skip_quiets) {
     if (this->idx >= this->moves.size()) {
@@ -63,13 +92,15 @@ std::optional<ScoredMove> MovePicker::next(const bool skip_quiets) {
         return std::nullopt;
     }
 
-    int best_idx = this->idx;
-
-    for (size_t i = (this->idx + 1); i < this->moves.size(); i++) {
-        if (moves[i].score > moves[best_idx].score) {
-            best_idx = i;
+    int best_idx;
+    do {
+        best_idx = this->idx;
+        for (size_t i = (this->idx + 1); i < this->moves.size(); i++) {
+            if (moves[i].score > moves[best_idx].score) {
+                best_idx = i;
+            }
         }
-    }
+    } while (!resolve_see(moves[best_idx]));
     std::swap(moves[best_idx], moves[idx]);
 
     const auto best_move = moves[idx];
@@ -6,13 +6,19 @@
 #include "history.hpp"
 #include "move.hpp"
 
+// noisy moves scoring below this are ordered after the quiet moves, and are skipped entirely by quiescence search
+constexpr Score see_ordering_threshold = -20;
+
 class MovePicker {
     private:
         MoveList moves;
         size_t idx;
+        const Position& pos;
+
+        bool resolve_see(ScoredMove& move);
 
     public:
-        MovePicker(MoveList&& input_moves, const Position& pos, const BoardHistory& hist, const Move pv_move, const HistoryTable& history_table, Move killer);
+        MovePicker(MoveList&& input_moves, const Position& pos, const SearchStackFrame& parent, const Move pv_move, const HistoryTable& history_table, Move killer);
         std::optional<ScoredMove> next(const bool skip_quiets);
 
         const ScoredMove& operator[](size_t idx) { return moves[idx]; };
@@ -3,6 +3,7 @@
 #include <cinttypes>
 #include <iostream>
 #include <limits>
+#include <sstream>
 #include <vector>
 
 #include "move_generator.hpp"
@@ -38,6 +39,11 @@ TUNABLE_SPECIFIER auto see_prune_depth = TUNABLE_INT("see_prune_depth", 10, 5, 1
 TUNABLE_SPECIFIER auto noisy_see_prune_multi = TUNABLE_INT("noisy_see_prune_multi", -20, -35, -5);
 TUNABLE_SPECIFIER auto quiet_see_prune_multi = TUNABLE_INT("quiet_see_prune_multi", -61, -100, -30);
 
+TUNABLE_SPECIFIER auto se_enabled = TUNABLE_INT("se_enabled", 0, 0, 1);
+TUNABLE_SPECIFIER auto se_depth = TUNABLE_INT("se_depth", 8, 6, 10);
+TUNABLE_SPECIFIER auto se_tt_depth_margin = TUNABLE_INT("se_tt_depth_margin", 3, 1, 5);
+TUNABLE_SPECIFIER auto se_beta_multi = TUNABLE_INT("se_beta_multi", 2, 1, 4);
+
 TUNABLE_SPECIFIER auto asp_window = TUNABLE_INT("asp_window", 25, 10, 50);
 
 template <bool print_debug> // this could just as easily be done as a parameter but this gives some practice with templates
@@ -90,6 +96,10 @@ uint64_t Perft::run_perft(Position& board, int depth, bool print_debug) {
 
 Move Search::select_random_move(const Position& pos) {
     auto moves = MoveGenerator::generate_legal_moves<MoveGenType::ALL_LEGAL>(pos, pos.stm());
+    if (moves.size() == 0) {
+        // checkmate or stalemate, for which UCI's bestmove is the null move
+        return Move::NULL_MOVE();
+    }
     return moves[rand() % moves.size()].move;
 }
 
@@ -199,6 +209,93 @@ bool Search::static_exchange_evaluation(const Position& pos, const Move move, co
     return pos.stm() != moving_side;
 }
 
+/**
+ * @brief Computes the exact material outcome of the exchange sequence started by move, using the same piece values and capture rules as
+ * static_exchange_evaluation, so that static_exchange_value(pos, move) >= threshold agrees with static_exchange_evaluation(pos, move, threshold).
+ * This is slower than a single threshold test, but lets the result be cached and compared against any number of thresholds
+ *
+ * @param pos
+ * @param move
+ * @return Score
+ */
+Score Search::static_exchange_value(const Position& pos, const Move move) {
+    // at most 32 pieces can take part in the exchange
+    std::array<Score, 33> gains;
+    int depth = 0;
+
+    PieceTypes next_victim = move.is_promotion() ? move.promo_type() : pos.piece_at(move.src_sq()).type();
+    gains[0] = Search::SEEScores[static_cast<int>(pos.piece_at(move.dst_sq()).type())];
+    if (move.is_promotion()) {
+        gains[0] += (Search::SEEScores[static_cast<int>(move.promo_type())] - Search::SEEScores[static_cast<int>(PieceTypes::PAWN)]);
+    } else if (move.flags() == MoveFlags::EN_PASSANT_CAPTURE) {
+        gains[0] = Search::SEEScores[static_cast<int>(PieceTypes::PAWN)];
+    }
+
+    const Bitboard bishops = pos.bishops() | pos.queens();
+    const Bitboard rooks = pos.rooks() | pos.queens();
+
+    Bitboard occupied = pos.occupancy();
+    occupied ^= move.src_sq();
+    occupied |= move.dst_sq();
+    if (move.flags() == MoveFlags::EN_PASSANT_CAPTURE) {
+        const auto ep_target = get_position(move.src_rnk(), move.dst_fle());
+        occupied ^= ep_target;
+    }
+
+    Bitboard attackers = (MoveGenerator::get_attackers(pos, pos.stm(), move.dst_sq(), occupied)
+                          | MoveGenerator::get_attackers(pos, enemy_side(pos.stm()), move.dst_sq(), occupied))
+                         & occupied;
+
+    Side moving_side = enemy_side(pos.stm());
+
+    while (true) {
+        const Bitboard this_side_attackers = attackers & pos.occupancy(moving_side);
+
+        if (this_side_attackers.empty()) {
+            break;
+        }
+
+        PieceTypes attacker_type;
+        Bitboard victim_attackers = 0;
+        for (attacker_type = PieceTypes::PAWN; attacker_type <= PieceTypes::QUEEN;
+             attacker_type = static_cast<PieceTypes>(static_cast<int>(attacker_type) + 1)) {
+            victim_attackers = this_side_attackers & pos.get_bb(static_cast<int>(attacker_type) - 1, static_cast<int>(moving_side));
+            if (!victim_attackers.empty()) {
+                break;
+            }
+        }
+
+        occupied ^= (victim_attackers.bb & -(victim_attackers.bb));
+
+        if (attacker_type == PieceTypes::PAWN || attacker_type == PieceTypes::BISHOP || attacker_type == PieceTypes::QUEEN) {
+            attackers |= MoveGenerator::generate_bishop_mm(occupied, move.dst_sq()) & bishops;
+        }
+
+        if (attacker_type == PieceTypes::ROOK || attacker_type == PieceTypes::QUEEN) {
+            attackers |= MoveGenerator::generate_rook_mm(occupied, move.dst_sq()) & rooks;
+        }
+
+        attackers &= occupied;
+
+        if (attacker_type == PieceTypes::KING && !(attackers & pos.occupancy(enemy_side(moving_side))).empty()) {
+            // the king can't capture onto a defended square
+            break;
+        }
+
+        depth += 1;
+        gains[depth] = Search::SEEScores[static_cast<int>(next_victim)] - gains[depth - 1];
+        next_victim = attacker_type;
+        moving_side = enemy_side(moving_side);
+    }
+
+    // each side only continues the exchange if doing so is better than stopping
+    while (depth > 0) {
+        gains[depth - 1] = -std::max<Score>(-gains[depth - 1], gains[depth]);
+        depth -= 1;
+    }
+    return gains[0];
+}
+
 bool Search::detect_insufficient_material(const Position& board, const Side side) {
     const Side enemy = enemy_side(side);
     if (board.occupancy(enemy) == board.kings(enemy)) {
@@ -214,12 +311,44 @@ bool Search::detect_insufficient_material(const Position& board, const Side side
     return false;
 }
 
+/**
+ * @brief The number of moves to mate for a root score, negative if the side to move is the one being mated, or 0 if the score isn't
+ * a mate.  Mate scores count plies from the bottom of the search stack, which starts PLY_OFFSET below the root
+ */
+int Search::moves_to_mate(Score score) {
+    if (std::abs(score) < MagicNumbers::PositiveInfinity - MAX_PLY) {
+        return 0;
+    }
+    const auto plies = MagicNumbers::PositiveInfinity - std::abs(score) - PLY_OFFSET;
+    return (score > 0) ? (plies + 1) / 2 : -((plies + 1) / 2);
+}
+
+Score SearchHandler::evaluate(const Position& pos) {
+    const auto cached = eval_cache.probe(pos.zobrist_key());
+    if (cached.has_value()) {
+        return *cached;
+    }
+    const auto eval = Evaluation::evaluate_board(pos, pawn_table);
+    eval_cache.store(pos.zobrist_key(), eval);
+    return eval;
+}
+
 template <NodeTypes node_type>
 Score SearchHandler::negamax_step(const Position& old_pos, Score alpha, Score beta, int depth, int ply, uint64_t& node_count, bool is_cut_node) {
 
+    // a singular extension's verification search, which searches this position again without the TT move
+    const auto excluded_move = search_stack[ply].excluded_move;
+    const bool is_singular_search = !excluded_move.is_null_move();
+    // writes this node to the search trace as it returns; a singular verification search is marked as one whatever it returned with
+    const auto traced = [&, entry_alpha = alpha](Score score, TraceEvent event) {
+        tracer.record(node_count, ply, depth, entry_alpha, beta, score, search_stack[ply - 1].current_move, static_cast<uint8_t>(node_type),
+                      is_singular_search ? TraceEvent::SINGULAR_VERIFICATION : event);
+        return score;
+    };
+
     pv_table.pv_length[ply] = ply;
     if (Search::is_draw(old_pos, board_hist)) {
-        return 0;
+        return traced(0, TraceEvent::DRAW);
     }
 
     constexpr auto pv_node_type = is_pv_node(node_type) ? NodeTypes::PV_NODE : NodeTypes::NON_PV_NODE;
@@ -228,24 +357,35 @@ Score SearchHandler::negamax_step(const Position& old_pos, Score alpha, Score be
 
     const auto entry = tt.probe(old_pos);
     const auto tt_hit = entry.has_value();
+    tt_probes += 1;
+    tt_hits += tt_hit;
+    if (depth > 0) {
+        // nodes at depth 0 and below are counted by the quiescence search they drop into
+        stats.add(SearchStat::NODE, depth);
+        if (tt_hit) {
+            stats.add(SearchStat::TT_HIT, depth);
+        }
+    }
     if constexpr (!is_pv_node(node_type)) {
         const bool should_cutoff =
             tt_hit
+            && !is_singular_search
             && entry->get().depth() >= depth
             && (entry->get().bound_type() == BoundTypes::EXACT_BOUND
                 || (entry->get().bound_type() == BoundTypes::LOWER_BOUND && entry->get().score() >= beta)
                 || (entry->get().bound_type() == BoundTypes::UPPER_BOUND && entry->get().score() <= alpha));
         if (should_cutoff) {
+            stats.add(SearchStat::TT_CUTOFF, depth);
             // Positive infinity is a a mate at this square
             // Negative infinity is being mated at this square
             // A mate score is therefore greater than (positive_infinity - max_ply) or
             // less than (negative_infinity + max_ply)
             if (entry->get().score() == MagicNumbers::PositiveInfinity) {
-                return MagicNumbers::PositiveInfinity - ply;
+                return traced(MagicNumbers::PositiveInfinity - ply, TraceEvent::TT_CUTOFF);
             } else if (entry->get().score() <= (MagicNumbers::NegativeInfinity + MAX_PLY)) {
-                return MagicNumbers::NegativeInfinity + ply;
+                return traced(MagicNumbers::NegativeInfinity + ply, TraceEvent::TT_CUTOFF);
             }
-            return entry->get().score();
+            return traced(entry->get().score(), TraceEvent::TT_CUTOFF);
         }
     }
 
@@ -264,7 +404,7 @@ Score SearchHandler::negamax_step(const Position& old_pos, Score alpha, Score be
         } else if (tt_hit && entry->get().static_eval() > (MagicNumbers::NegativeInfinity + MAX_PLY)) {
             return entry->get().static_eval();
         } else {
-            return Evaluation::evaluate_board(old_pos);
+            return evaluate(old_pos);
         }
     }();
 
@@ -288,43 +428,52 @@ Score SearchHandler::negamax_step(const Position& old_pos, Score alpha, Score be
     }();
 
     if (ply >= MAX_PLY) {
-        return static_eval;
+        return traced(static_eval, TraceEvent::MAX_PLY);
     }
 
+    search_stack[ply].static_eval = adjusted_eval;
+    search_stack[ply].in_check = old_pos.in_check();
+    search_stack[ply].current_move = Move::NULL_MOVE();
+
     const auto improving = [&]() {
         if (old_pos.in_check()) {
             return false;
         }
 
-        if (board_hist.len() >= 3 && !board_hist[board_hist.len() - 3].in_check()) {
-            return static_eval > Evaluation::evaluate_board(board_hist[board_hist.len() - 3]);
-        } else if (board_hist.len() >= 5 && !board_hist[board_hist.len() - 5].in_check()) {
-            return static_eval > Evaluation::evaluate_board(board_hist[board_hist.len() - 5]);
+        if (ply >= 2 && search_stack[ply - 2].static_eval != MagicNumbers::NegativeInfinity) {
+            return static_eval > search_stack[ply - 2].static_eval;
+        } else if (ply >= 4 && search_stack[ply - 4].static_eval != MagicNumbers::NegativeInfinity) {
+            return static_eval > search_stack[ply - 4].static_eval;
         }
         return false;
     }();
 
     // Reverse futility pruning
     if constexpr (!is_pv_node(node_type)) {
-        if (!old_pos.in_check() && depth < rfp_depth && (static_eval - (rfp_margin * depth)) >= beta) {
-            return static_eval;
+        if (!old_pos.in_check() && !is_singular_search && depth < rfp_depth && (static_eval - (rfp_margin * depth)) >= beta) {
+            stats.add(SearchStat::RFP_PRUNE, depth);
+            return traced(static_eval, TraceEvent::RFP);
         }
     }
 
     if constexpr (!is_pv_node(node_type)) {
-        if (!old_pos.in_check() && static_eval < alpha - razoring_offset - razoring_multi * depth * depth) {
+        if (!old_pos.in_check() && !is_singular_search && static_eval < alpha - razoring_offset - razoring_multi * depth * depth) {
             const auto razoring_score = quiescent_search<NodeTypes::NON_PV_NODE>(old_pos, alpha - 1, alpha, ply + 1, node_count);
             if (razoring_score < alpha) {
-                return razoring_score;
+                stats.add(SearchStat::RAZOR_PRUNE, depth);
+                return traced(razoring_score, TraceEvent::RAZOR);
             }
         }
     }
 
     if constexpr (!is_pv_node(node_type)) {
-        if (static_eval >= beta && !old_pos.in_check() && depth >= nmp_depth) {
+        if (static_eval >= beta && !old_pos.in_check() && !is_singular_search && depth >= nmp_depth) {
             // Try null move pruning if we aren't in check
 
-            if (!board_hist.move_at(board_hist.len() - 1).is_null_move()) {
+            if (!search_stack[ply - 1].current_move.is_null_move()) {
+                stats.add(SearchStat::NMP_ATTEMPT, depth);
+                search_stack[ply].current_move = Move::NULL_MOVE();
+                search_stack[ply].reduction = 0;
                 auto& board = old_pos.make_move(Move::NULL_MOVE(), board_hist);
                 
                 const auto nmp_reduction = base_nmp_reduction
@@ -335,10 +484,11 @@ Score SearchHandler::negamax_step(const Position& old_pos, Score alpha, Score be
 
                 board_hist.pop_board();
                 if (null_score >= beta) {
+                    stats.add(SearchStat::NMP_CUTOFF, depth);
                     if (null_score > MagicNumbers::PositiveInfinity - MAX_PLY) {
-                        return beta;
+                        return traced(beta, TraceEvent::NMP);
                     } else {
-                        return null_score;
+                        return traced(null_score, TraceEvent::NMP);
                     }
                 }
             }
@@ -349,9 +499,9 @@ Score SearchHandler::negamax_step(const Position& old_pos, Score alpha, Score be
     if (moves.size() == 0) {
         if (old_pos.in_check()) {
             // if in check
-            return ply + MagicNumbers::NegativeInfinity;
+            return traced(ply + MagicNumbers::NegativeInfinity, TraceEvent::CHECKMATE);
         } else {
-            return 0;
+            return traced(0, TraceEvent::STALEMATE);
         }
     } else if (moves.size() == 1) {
         extensions += 1;
@@ -359,7 +509,7 @@ Score SearchHandler::negamax_step(const Position& old_pos, Score alpha, Score be
     // mate and draw detection
 
     const bool tt_move = tt_hit && MoveGenerator::is_move_pseudolegal(old_pos, entry->get().move()) && MoveGenerator::is_move_legal(old_pos, entry->get().move());
-    auto mp = MovePicker(std::move(moves), old_pos, board_hist, tt_move ? entry->get().move() : Move::NULL_MOVE(), history_table,
+    auto mp = MovePicker(std::move(moves), old_pos, search_stack[ply - 1], tt_move ? entry->get().move() : Move::NULL_MOVE(), history_table,
                                 search_stack[ply].killer_move);
     // move reordering
     // tt_hit in tt_move condition guards against null entry access
@@ -376,15 +526,24 @@ Score SearchHandler::negamax_step(const Position& old_pos, Score alpha, Score be
     UnscoredMoveList evaluated_moves;
     bool skip_quiets = false;
     while ((opt_move = mp.next(skip_quiets)).has_value()) {
+        if (node_count >= hard_node_limit) {
+            search_cancelled = true;
+        }
         if (search_cancelled) {
             break;
         }
         const auto move = opt_move.value();
+        if (move.move == excluded_move) {
+            continue;
+        }
 
         if constexpr (!is_pv_node(node_type)) {
             // late move pruning
             if (depth <= lmp_depth && !old_pos.in_check() && move.move.is_quiet() && evaluated_moves.size() >= static_cast<size_t>(((depth * depth) + lmp_offset) / (2 - improving))) {
                 skip_quiets = true;
+                stats.add(SearchStat::LMP_PRUNE, depth);
+                tracer.record(node_count, ply + 1, depth - 1, -beta, -alpha, 0, move.move, static_cast<uint8_t>(node_type),
+                              TraceEvent::LMP);
                 continue;
             }
         }
@@ -393,27 +552,79 @@ Score SearchHandler::negamax_step(const Position& old_pos, Score alpha, Score be
         if (!old_pos.in_check() && best_score > (MagicNumbers::NegativeInfinity + MAX_PLY) && !move.move.is_capture() && depth <= fp_depth
             && static_eval + fp_multi * depth < alpha) {
             skip_quiets = true;
+            stats.add(SearchStat::FUTILITY_PRUNE, depth);
+            tracer.record(node_count, ply + 1, depth - 1, -beta, -alpha, 0, move.move, static_cast<uint8_t>(node_type),
+                          TraceEvent::FUTILITY);
             continue;
         }
 
         // history pruning
         if constexpr (!is_pv_node(node_type)) {
-            if (best_score > (MagicNumbers::NegativeInfinity + MAX_PLY) && evaluated_moves.size() > 0 && depth <= hp_depth && static_eval <= alpha && history_table.score(board_hist, move.move, old_pos.stm()) < -(depth * depth) * hp_multi) {
+            if (best_score > (MagicNumbers::NegativeInfinity + MAX_PLY) && evaluated_moves.size() > 0 && depth <= hp_depth && static_eval <= alpha && history_table.score(old_pos, search_stack[ply - 1], move.move) < -(depth * depth) * hp_multi) {
+                stats.add(SearchStat::HISTORY_PRUNE, depth);
+                tracer.record(node_count, ply + 1, depth - 1, -beta, -alpha, 0, move.move, static_cast<uint8_t>(node_type),
+                              TraceEvent::HISTORY);
                 continue;
             }
         }
 
-        if (depth <= see_prune_depth && best_score > (MagicNumbers::NegativeInfinity + MAX_PLY)
-            && !Search::static_exchange_evaluation(old_pos, move.move, move.move.is_capture() ? (noisy_see_prune_multi * depth * depth) : (quiet_see_prune_multi * depth))) {
-            continue;
+        if (depth <= see_prune_depth && best_score > (MagicNumbers::NegativeInfinity + MAX_PLY)) {
+            const int see_threshold = move.move.is_capture() ? (noisy_see_prune_multi * depth * depth) : (quiet_see_prune_multi * depth);
+            // noisy moves already had their exact SEE value computed by the move picker
+            if (move.move.is_noisy() ? move.see_value < see_threshold : !Search::static_exchange_evaluation(old_pos, move.move, see_threshold)) {
+                stats.add(SearchStat::SEE_PRUNE, depth);
+                tracer.record(node_count, ply + 1, depth - 1, -beta, -alpha, 0, move.move, static_cast<uint8_t>(node_type),
+                              TraceEvent::SEE);
+                continue;
+            }
+        }
+
+        // Singular extensions: if the TT move is the only move that comes close to its stored score, it's extended.  Otherwise, if even
+        // without it the position fails high, several moves beat beta and the node is cut off (multi-cut).  Off unless se_enabled is set,
+        // as neither time to solution on WAC nor a match has shown it to pay for the verification searches yet
+        int singular_extension = 0;
+        if constexpr (node_type != NodeTypes::ROOT_NODE) {
+            if (se_enabled && tt_move && move.move == entry->get().move() && !is_singular_search && depth >= se_depth) {
+                // the verification search may overwrite this slot, so everything it's compared against is read beforehand
+                const auto tt_score = entry->get().score();
+                const auto tt_depth = entry->get().depth();
+                const auto tt_bound = entry->get().bound_type();
+                if (tt_depth + se_tt_depth_margin >= depth && tt_bound != BoundTypes::UPPER_BOUND && std::abs(tt_score) < MATE_FOUND) {
+                    const Score singular_beta = tt_score - se_beta_multi * depth;
+                    stats.add(SearchStat::SINGULAR_SEARCH, depth);
+                    search_stack[ply].excluded_move = move.move;
+                    const auto singular_score = negamax_step<NodeTypes::NON_PV_NODE>(old_pos, singular_beta - 1, singular_beta, (depth - 1) / 2,
+                                                                                     ply, node_count, is_cut_node);
+                    search_stack[ply].excluded_move = Move::NULL_MOVE();
+                    if (singular_score < singular_beta) {
+                        stats.add(SearchStat::SINGULAR_EXTENSION, depth);
+                        singular_extension = 1;
+                    } else if (singular_beta >= beta) {
+                        stats.add(SearchStat::MULTI_CUT, depth);
+                        return traced(singular_beta, TraceEvent::MULTI_CUT);
+                    } else if (tt_score >= beta) {
+                        singular_extension = -1;
+                    }
+                }
+            }
         }
 
         tt.prefetch(old_pos.key_after(move.move));
+        search_stack[ply].current_move = move.move;
+        search_stack[ply].moved_piece = old_pos.piece_at(move.move.src_sq());
+        search_stack[ply].reduction = 0;
+        if constexpr (node_type == NodeTypes::ROOT_NODE) {
+            current_root_move = move.move;
+            current_root_move_number = evaluated_moves.size() + 1;
+        }
         const auto pre_move_node_count = node_count;
         auto& pos = old_pos.make_move(move.move, board_hist);
         node_count += 1;
+        if (node_count >= next_info_check) [[unlikely]] {
+            report_progress();
+        }
         Score score;
-        const auto new_depth = depth - 1 + extensions;
+        const auto new_depth = depth - 1 + extensions + singular_extension;
 
         // See if we can perform LMR
         if (depth > 2
@@ -431,12 +642,16 @@ Score SearchHandler::negamax_step(const Position& old_pos, Score alpha, Score be
                 // Reduce more if we aren't improving
                 return lmr_reduction;
             }(), 1, MAX_PLY - ply);
-            
+            search_stack[ply].reduction = new_depth - lmr_depth;
+            stats.add(SearchStat::LMR_SEARCH, depth);
+
             score = -negamax_step<NodeTypes::NON_PV_NODE>(pos, -(alpha + 1), -alpha, lmr_depth, ply + 1, node_count,
                                                           child_cutnode_type);
 
             // it's possible the LMR score will raise alpha; in this case we re-search with the full depth
             if (score > alpha) {
+                stats.add(SearchStat::LMR_RESEARCH, depth);
+                search_stack[ply].reduction = 0;
                 score = -negamax_step<NodeTypes::NON_PV_NODE>(pos, -(alpha + 1), -alpha, new_depth, ply + 1, node_count,
                                                               child_cutnode_type);
             }
@@ -470,8 +685,12 @@ Score SearchHandler::negamax_step(const Position& old_pos, Score alpha, Score be
                     pv_table.pv_length[ply] = pv_table.pv_length[ply + 1];
                 }
                 if (score >= beta) {
+                    stats.add(SearchStat::FAIL_HIGH, depth);
+                    if (evaluated_moves.size() == 0) {
+                        stats.add(SearchStat::FIRST_MOVE_FAIL_HIGH, depth);
+                    }
                     search_stack[ply].killer_move = move.move;
-                    history_table.update_scores(board_hist, evaluated_moves, move, old_pos.stm(), depth);
+                    history_table.update_scores(old_pos, search_stack[ply - 1], evaluated_moves, move, depth);
                     break;
                 }
                 alpha = score;
@@ -482,6 +701,11 @@ Score SearchHandler::negamax_step(const Position& old_pos, Score alpha, Score be
     const BoundTypes bound_type =
         (best_score >= beta ? BoundTypes::LOWER_BOUND : (alpha != original_alpha ? BoundTypes::EXACT_BOUND : BoundTypes::UPPER_BOUND));
 
+    if (is_singular_search) {
+        // the TT holds the result of searching every move, so a search that skipped one mustn't overwrite it
+        return traced(best_score, TraceEvent::SEARCHED);
+    }
+
     if (!old_pos.in_check()
         && std::abs(best_score) < MATE_FOUND
         && (best_move.is_null_move() || best_move.is_quiet())
@@ -491,24 +715,36 @@ Score SearchHandler::negamax_step(const Position& old_pos, Score alpha, Score be
         }
 
     tt.store(TranspositionTableEntry(best_move, depth, bound_type, best_score, raw_eval, old_pos.zobrist_key()), old_pos);
-    return best_score;
+    return traced(best_score, TraceEvent::SEARCHED);
 }
 
 template <NodeTypes node_type>
 Score SearchHandler::quiescent_search(const Position& old_pos, Score alpha, Score beta, int ply, uint64_t& node_count) {
+    const auto traced = [&, entry_alpha = alpha](Score score, TraceEvent event) {
+        tracer.record(node_count, ply, 0, entry_alpha, beta, score, search_stack[ply - 1].current_move, static_cast<uint8_t>(node_type),
+                      event);
+        return score;
+    };
+
     if (Search::is_draw(old_pos, board_hist)) {
-        return 0;
+        return traced(0, TraceEvent::DRAW);
     }
 
     const auto entry = tt.probe(old_pos);
     const auto tt_hit = entry.has_value();
+    tt_probes += 1;
+    tt_hits += tt_hit;
+    stats.add(SearchStat::QSEARCH_NODE, 0);
+    if (tt_hit) {
+        stats.add(SearchStat::TT_HIT, 0);
+    }
     if constexpr(!is_pv_node(node_type)) {
         if (tt_hit
             && entry->get().key() == static_cast<uint16_t>(old_pos.zobrist_key())
             && (entry->get().bound_type() == BoundTypes::EXACT_BOUND
                 || (entry->get().bound_type() == BoundTypes::LOWER_BOUND && entry->get().score() >= beta)
                 || (entry->get().bound_type() == BoundTypes::UPPER_BOUND && entry->get().score() <= alpha))) {
-                    return entry->get().score();
+                    return traced(entry->get().score(), TraceEvent::TT_CUTOFF);
         }
     }
 
@@ -518,7 +754,7 @@ Score SearchHandler::quiescent_search(const Position& old_pos, Score alpha, Scor
         }  else if (tt_hit && entry->get().static_eval() > (MagicNumbers::NegativeInfinity + MAX_PLY)) {
             return entry->get().static_eval();
         } else {
-            return Evaluation::evaluate_board(old_pos);
+            return evaluate(old_pos);
         }
     }();
 
@@ -531,12 +767,12 @@ Score SearchHandler::quiescent_search(const Position& old_pos, Score alpha, Scor
     }();
 
     if (ply >= MAX_PLY) {
-        return static_eval;
+        return traced(static_eval, TraceEvent::MAX_PLY);
     }
 
     // Stand pat; we assume the static eval is the lower bound of our score
     if (static_eval >= beta) {
-        return static_eval;
+        return traced(static_eval, TraceEvent::STAND_PAT);
     }
 
     alpha = std::max(static_eval, alpha);
@@ -546,18 +782,21 @@ Score SearchHandler::quiescent_search(const Position& old_pos, Score alpha, Scor
     } else {
         moves = MoveGenerator::generate_legal_moves<MoveGenType::QUIESCENCE>(old_pos, old_pos.stm());
     }
-    if (moves.size() == 0 && (old_pos.in_check() || MoveGenerator::generate_legal_moves<MoveGenType::NON_QUIESCENCE>(old_pos, old_pos.stm()).size() == 0)) {
+    if (moves.size() == 0 && (old_pos.in_check() || !MoveGenerator::has_legal_move(old_pos))) {
         if (old_pos.in_check()) {
             // if in check
-            return ply + MagicNumbers::NegativeInfinity;
+            return traced(ply + MagicNumbers::NegativeInfinity, TraceEvent::CHECKMATE);
         } else {
-            return 0;
+            return traced(0, TraceEvent::STALEMATE);
         }
     }
 
     Score best_score = static_eval;
     const auto original_alpha = alpha;
-    auto mp = MovePicker(std::move(moves), old_pos, board_hist, Move::NULL_MOVE(), history_table, search_stack[ply].killer_move);
+    search_stack[ply].in_check = old_pos.in_check();
+    // the move picker only matches the TT move against the generated moves, so it needn't be checked for legality here
+    const auto tt_move = tt_hit ? entry->get().move() : Move::NULL_MOVE();
+    auto mp = MovePicker(std::move(moves), old_pos, search_stack[ply - 1], tt_move, history_table, search_stack[ply].killer_move);
     int total_moves = 0;
     Move best_move = Move::NULL_MOVE();
     std::optional<ScoredMove> opt_move;
@@ -567,12 +806,13 @@ Score SearchHandler::quiescent_search(const Position& old_pos, Score alpha, Scor
         }
         const auto move = *opt_move;
 
-        if (move.move.is_noisy()) {
-            if (!move.see_ordering_result) {
-                continue;
-            }
+        if (move.move.is_noisy() && move.see_value < see_ordering_threshold) {
+            continue;
         }
 
+        tt.prefetch(old_pos.key_after(move.move));
+        search_stack[ply].current_move = move.move;
+        search_stack[ply].moved_piece = old_pos.piece_at(move.move.src_sq());
         auto& pos = old_pos.make_move(move.move, board_hist);
         node_count += 1;
         Score score;
@@ -606,7 +846,7 @@ Score SearchHandler::quiescent_search(const Position& old_pos, Score alpha, Scor
     const BoundTypes bound_type =
         (best_score >= beta ? BoundTypes::LOWER_BOUND : (alpha != original_alpha ? BoundTypes::EXACT_BOUND : BoundTypes::UPPER_BOUND));
     tt.store(TranspositionTableEntry(best_move, 0, bound_type, best_score, raw_eval, old_pos.zobrist_key()), old_pos);
-    return best_score;
+    return traced(best_score, TraceEvent::QSEARCHED);
 }
 
 Score SearchHandler::run_aspiration_window_search(int depth, Score previous_score) {
@@ -637,11 +877,57 @@ Score SearchHandler::run_aspiration_window_search(int depth, Score previous_scor
     return previous_score;
 }
 
+void SearchHandler::send_info(const std::string& line) {
+    if (info_callback) {
+        info_callback(line);
+    } else {
+        output->write_line(line);
+    }
+    last_info = std::chrono::steady_clock::now();
+}
+
+/**
+ * @brief Called every info_check_nodes nodes.  If nothing has been sent for the info interval, sends the last completed depth's line
+ * if it was held back, or otherwise the move being searched at the root and the node count, so that the GUI hears from a long
+ * iteration before it finishes
+ */
+void SearchHandler::report_progress() {
+    next_info_check = node_count + info_check_nodes;
+    const auto now = std::chrono::steady_clock::now();
+    if (now - last_info < info_interval) {
+        return;
+    }
+    if (!pending_info.empty()) {
+        // a completed depth that was held back says more than the progress line would
+        send_info(pending_info);
+        pending_info.clear();
+        return;
+    }
+    const auto time_so_far = std::max(std::chrono::duration_cast<std::chrono::milliseconds>(now - search_start).count(), (int64_t) 1);
+    const auto nps = static_cast<uint64_t>(node_count / (static_cast<float>(time_so_far) / 1000));
+    std::ostringstream info;
+    info << "info depth " << current_depth << " currmove " << current_root_move.to_string() << " currmovenumber "
+         << current_root_move_number << " nodes " << node_count << " nps " << nps << " hashfull " << tt.hashfull() << " time "
+         << time_so_far;
+    send_info(info.str());
+}
+
 Move SearchHandler::run_iterative_deepening_search() {
     node_count = 0;
+    stats.clear();
+    tt_hits = 0;
+    tt_probes = 0;
+    completed_depth = 0;
     pv_move = Move::NULL_MOVE();
+    root_score = 0;
+    const auto [soft_node_limit, hard_limit] = TimeManagement::get_node_limits(tc);
+    hard_node_limit = hard_limit;
     // reset pv move so we don't accidentally play an illegal one from a previous search
-    const auto search_start_point = std::chrono::steady_clock::now();
+    search_start = std::chrono::steady_clock::now();
+    // nothing has been sent yet, so the first line always goes out
+    last_info = std::chrono::steady_clock::time_point{};
+    next_info_check = print_info ? info_check_nodes : std::numeric_limits<uint64_t>::max();
+    pending_info.clear();
     // TranspositionTable transpositions;
     auto moves =
         MoveGenerator::generate_legal_moves<MoveGenType::ALL_LEGAL>(board_hist[board_hist.len() - 1], board_hist[board_hist.len() - 1].stm());
@@ -658,36 +944,66 @@ Move SearchHandler::run_iterative_deepening_search() {
         pv_table.pv_array[i].fill(Move::NULL_MOVE());
     }
     std::for_each(search_stack.begin(), search_stack.end(), [](SearchStackFrame& elem) { elem = SearchStackFrame(); });
+    if (board_hist.len() >= 2) {
+        // the frame below the root continues from the game's last move
+        auto& previous = search_stack[PLY_OFFSET - 1];
+        previous.current_move = board_hist.move_at(board_hist.len() - 1);
+        previous.moved_piece = board_hist[board_hist.len() - 2].piece_at(previous.current_move.src_sq());
+        previous.in_check = board_hist[board_hist.len() - 2].in_check();
+    }
 
     Score current_score = 0;
-    for (int depth = 1; depth <= TimeManagement::get_search_depth(tc) && !search_cancelled; depth++) {
+    const int max_depth = TimeManagement::get_search_depth(tc);
+    for (int depth = std::min(start_depth, max_depth); depth <= max_depth && !search_cancelled; depth++) {
+        current_depth = depth;
 
         current_score = run_aspiration_window_search(depth, current_score);
         const auto time_so_far = std::max(
-            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - search_start_point).count(), (int64_t) 1);
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - search_start).count(), (int64_t) 1);
         // Set time so far to a minimum of 1 to avoid divide by 0 in nps calculation
 
         if (!search_cancelled && print_info) {
             const auto nps = static_cast<uint64_t>(node_count / (static_cast<float>(time_so_far) / 1000));
-            std::cout << "info depth " << depth << " nodes " << node_count << " nps " << nps << " score "
-                      << ((std::abs(current_score) >= (MagicNumbers::PositiveInfinity - MAX_PLY))
-                              ? ("mate " + std::to_string(((current_score / std::abs(current_score)) * (depth + 1)) / 2))
-                              : ("cp " + std::to_string(current_score)))
-                      << " time " << time_so_far << " pv ";
+            std::ostringstream info;
+            info << "info depth " << depth << " nodes " << node_count << " nps " << nps << " hashfull " << tt.hashfull() << " score "
+                 << ((std::abs(current_score) >= (MagicNumbers::PositiveInfinity - MAX_PLY))
+                         ? ("mate " + std::to_string(((current_score / std::abs(current_score)) * (depth + 1)) / 2))
+                         : ("cp " + std::to_string(current_score)))
+                 << " time " << time_so_far << " pv ";
             for (int i = 0; i < (pv_table.pv_length[PLY_OFFSET] - PLY_OFFSET); i++) {
-                std::cout << pv_table.pv_array[PLY_OFFSET][i + PLY_OFFSET].to_string() << " ";
+                info << pv_table.pv_array[PLY_OFFSET][i + PLY_OFFSET].to_string() << " ";
+            }
+            if (std::chrono::steady_clock::now() - last_info >= info_interval) {
+                send_info(info.str());
+                pending_info.clear();
+            } else {
+                pending_info = info.str();
             }
-            std::cout << std::endl;
+        }
+
+        if (!search_cancelled) {
+            root_score = current_score;
+            completed_depth = depth;
         }
 
         if (current_score >= (MagicNumbers::PositiveInfinity - MAX_PLY)) {
+            if (!pending_info.empty()) {
+                send_info(pending_info);
+            }
             return pv_move;
         }
 
+        if (node_count >= soft_node_limit) {
+            break;
+        }
+
         if (TimeManagement::is_time_based_tc(tc) && time_so_far > TimeManagement::calculate_soft_limit(tc, node_spent_table, pv_move, node_count)) {
             break;
         }
     }
+    if (!pending_info.empty()) {
+        send_info(pending_info);
+    }
     tt.age(); // Age the TT after every search
     return pv_move;
 }
\ No newline at end of file
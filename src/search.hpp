@@ -1,21 +1,29 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <functional>
 #include <future>
 #include <mutex>
 #include <optional>
 #include <semaphore>
+#include <string>
 #include <thread>
+#include <vector>
 
 #include <cmath>
 
 #include "chessboard.hpp"
 #include "evaluation.hpp"
 #include "history.hpp"
+#include "search_stack.hpp"
+#include "search_stats.hpp"
+#include "search_trace.hpp"
 #include "time_management.hpp"
 #include "ttable.hpp"
 #include "tunable.hpp"
+#include "uci_io.hpp"
 
 constexpr auto default_see_pawn_value = 97;
 constexpr auto default_see_knight_value = 292;
@@ -23,6 +31,11 @@ constexpr auto default_see_bishop_value = 281;
 constexpr auto default_see_rook_value = 509;
 constexpr auto default_see_queen_value = 920;
 
+// info lines are sent at most this often, apart from the last completed depth's, which always goes out before the bestmove
+constexpr int default_info_interval_ms = 250;
+// how many nodes the search goes between looking at the clock to see whether a progress line is due
+constexpr uint64_t info_check_nodes = 4096;
+
 enum class NodeTypes {
     ROOT_NODE,
     PV_NODE,
@@ -58,7 +71,9 @@ namespace Search {
     bool is_threefold_repetition(const BoardHistory& m, const int halfmove_clock, const ZobristKey z);
     bool is_draw(const Position& c, const BoardHistory& m);
     bool static_exchange_evaluation(const Position& pos, const Move move, const int threshold);
+    Score static_exchange_value(const Position& pos, const Move move);
     bool detect_insufficient_material(const Position& pos, const Side side);
+    int moves_to_mate(Score score);
 } // namespace Search
 
 inline std::array<std::array<int, MAX_TURN_MOVE_COUNT + 1>, MAX_PLY + 1> LmrTable;
@@ -85,15 +100,48 @@ inline std::array<std::array<int, MAX_TURN_MOVE_COUNT + 1>, MAX_PLY + 1> generat
 }
 
 
-struct SearchStackFrame {
-    Move killer_move = Move::NULL_MOVE();
-};
-
 struct PvTable {
     std::array<int, MAX_PLY + 1> pv_length;
     std::array<std::array<Move, MAX_PLY + 1>, MAX_PLY + 1> pv_array;
 };
 
+/**
+ * @brief What one bench search of a single position did, in the form written out by bench --json
+ */
+struct BenchPositionResult {
+    uint64_t nodes;
+    int64_t time_us;
+    int depth;
+    uint64_t tt_hits;
+    uint64_t tt_probes;
+};
+
+/**
+ * @brief The arguments of bench: bench [depth] [--json] [--repeat N], or bench <depth> <threads> [hash] for the multithreaded bench
+ */
+struct BenchSettings {
+    uint16_t depth = 14;
+    bool json = false;
+    int repetitions = 1;
+    // zero for the single threaded bench
+    int threads = 0;
+    size_t hash_mb = 16;
+};
+
+// the bench settings, or nothing if an argument is unknown or out of range
+std::optional<BenchSettings> parse_bench_args(const std::vector<std::string>& args);
+
+/**
+ * @brief What the multithreaded bench searched, summed per position and per thread
+ */
+struct SmpBenchSummary {
+    std::vector<uint64_t> position_nodes;
+    std::vector<uint64_t> thread_nodes;
+    uint64_t total_nodes = 0;
+    int64_t single_time_us = 0;
+    int64_t multi_time_us = 0;
+};
+
 class SearchHandler {
     private:
         std::thread search_thread;
@@ -101,8 +149,12 @@ class SearchHandler {
         std::mutex search_mutex;
         std::condition_variable cv;
         
+        // shadows the global table, so that each handler can be given a table of its own
+        TranspositionTable& tt;
         BoardHistory board_hist;
         HistoryTable history_table;
+        PawnTable pawn_table;
+        EvalCache eval_cache;
         std::array<uint64_t, 4096> node_spent_table;
         std::array<SearchStackFrame, MAX_PLY + 2> search_stack;
         PvTable pv_table;
@@ -113,17 +165,42 @@ class SearchHandler {
         uint16_t perft_depth;
         TimeControlInfo tc;
         Move pv_move;
+        Score root_score = 0;
         uint64_t node_count;
+        uint64_t tt_hits, tt_probes;
+        SearchStats stats;
+        SearchTracer tracer;
+        int completed_depth;
+        uint64_t hard_node_limit = std::numeric_limits<uint64_t>::max();
         bool print_info = true;
+        // receives each info line in place of the output, for callers embedding the engine
+        std::function<void(const std::string&)> info_callback;
+        UciOutput* output = &uci_output();
+        std::chrono::milliseconds info_interval{default_info_interval_ms};
+        std::chrono::steady_clock::time_point search_start, last_info;
+        // the node count at which the search next looks at the clock, so that the hot path only compares two counters
+        uint64_t next_info_check = std::numeric_limits<uint64_t>::max();
+        // the last completed depth's line, if it came too soon after the one before to be sent
+        std::string pending_info;
+        int current_depth = 0;
+        // the first depth iterative deepening searches, which lazy SMP helpers stagger so that they don't all repeat the main thread
+        int start_depth = 1;
+        Move current_root_move;
+        size_t current_root_move_number = 0;
 
         void search_thread_function();
+        void send_info(const std::string& line);
+        void report_progress();
+        Score evaluate(const Position& pos);
         Score run_aspiration_window_search(int depth, Score previous_score);
         template <NodeTypes node_type> Score negamax_step(const Position& pos, Score alpha, Score beta, int depth, int ply, uint64_t& node_count, bool is_cut_node);
         template <NodeTypes node_type> Score quiescent_search(const Position& pos, Score alpha, Score beta, int ply, uint64_t& node_count);
         Move run_iterative_deepening_search();
+        BenchPositionResult run_bench_position(const char* fen, uint16_t depth);
+        void run_json_bench(uint16_t depth, int repetitions);
 
     public:
-        SearchHandler();
+        SearchHandler(TranspositionTable& table = ::tt);
         ~SearchHandler() { this->shutdown(); };
 
         bool is_searching() { return this->in_search; };
@@ -131,19 +208,32 @@ class SearchHandler {
         Position& get_pos() { return this->board_hist[board_hist.len() - 1]; };
         BoardHistory& get_history() { return this->board_hist; };
 
-        void set_pos(const Position& c) { 
-            this->board_hist = BoardHistory(c);
+        void set_pos(const Position& c) {
+            // reuses the history's storage, as constructing a new one allocates room for the longest possible game
+            this->board_hist.clear();
+            this->board_hist.push_board(c);
         };
         void set_history(const BoardHistory& h) {
             this->board_hist = h;
         }
-        uint64_t get_node_count() { return node_count; };
+        uint64_t get_node_count() const { return node_count; };
+        int get_completed_depth() const { return completed_depth; };
+        std::vector<Move> get_pv() const;
         void set_print_info(bool print) { print_info = print; };
+        void set_info_callback(std::function<void(const std::string&)> callback) { info_callback = std::move(callback); };
+        void set_output(UciOutput& out) { output = &out; };
+        void set_info_interval(int ms) { info_interval = std::chrono::milliseconds(ms); };
+        void set_start_depth(int depth) { start_depth = std::max(depth, 1); };
+        SearchTracer& get_tracer() { return tracer; };
         void reset();
 
         void search(const TimeControlInfo& tc);
-        void run_bench(uint16_t depth=14);
+        std::pair<Move, Score> search_sync(const TimeControlInfo& tc);
+        void run_bench(uint16_t depth=14, bool json=false, int repetitions=1);
+        static SmpBenchSummary run_smp_bench(uint16_t depth, int threads, size_t hash_mb);
         void run_perft(uint16_t depth);
+        static void run_movegen_bench(uint32_t iterations=20000);
+        static void run_eval_bench(uint32_t iterations=20000);
 
         void EndSearch() { search_cancelled = true; }
 
@@ -1,9 +1,19 @@
 #include "search.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
 #include <iostream>
+#include <memory>
+#include <numeric>
+#include <vector>
 
+#include <sys/resource.h>
+
+#include "bench_fens.hpp"
 #include "common.hpp"
 #include "move_generator.hpp"
+#include "uci.hpp"
 
 void SearchHandler::search_thread_function() {
     int this_search_id;
@@ -28,10 +38,11 @@ void SearchHandler::search_thread_function() {
                     // Just choose a random move
                 }
                 if (this_search_id == current_search_id && print_info) {
-                    printf("bestmove %s\n", move.to_string().c_str());
-                    fflush(stdout);
+                    // the info lines go out ahead of the statistics, which are printed directly
+                    output->flush();
+                    stats.print();
+                    output->send("bestmove " + move.to_string());
                 }
-                // We've had issues with stdout not being flushed in the past
             }
         }
         in_search = false;
@@ -47,7 +58,7 @@ void SearchHandler::shutdown() {
     this->search_thread.join();
 }
 
-SearchHandler::SearchHandler() { 
+SearchHandler::SearchHandler(TranspositionTable& table) : tt(table) {
     this->search_thread = std::thread(&SearchHandler::search_thread_function, this);
     recompute_table();
 }
@@ -73,6 +84,48 @@ void SearchHandler::search(const TimeControlInfo& tc) {
     }
 }
 
+/**
+ * @brief Searches the current position on the calling thread rather than the search thread, for callers that drive many searches
+ * themselves and only need the result
+ *
+ * @param tc
+ * @return std::pair<Move, Score> The best move and its score from the side to move's perspective
+ */
+std::pair<Move, Score> SearchHandler::search_sync(const TimeControlInfo& tc) {
+    std::lock_guard<std::mutex> lock(search_mutex);
+    this->tc = tc;
+    search_cancelled = false;
+    if (!TimeManagement::is_time_based_tc(tc)) {
+        const auto move = run_iterative_deepening_search();
+        return std::make_pair(move, root_score);
+    }
+
+    // without the search thread's timer a timed search would only stop between iterations, so this one stops it instead, unless
+    // the search finishes first
+    std::mutex timer_mutex;
+    std::condition_variable timer_cv;
+    bool finished = false;
+    std::thread timer([&, search_time = TimeManagement::get_search_time(tc)]() {
+        std::unique_lock<std::mutex> timer_lock(timer_mutex);
+        if (!timer_cv.wait_for(timer_lock, std::chrono::milliseconds{search_time}, [&] { return finished; })) {
+            this->EndSearch();
+        }
+    });
+    const auto move = run_iterative_deepening_search();
+    {
+        std::lock_guard<std::mutex> timer_lock(timer_mutex);
+        finished = true;
+    }
+    timer_cv.notify_one();
+    timer.join();
+    return std::make_pair(move, root_score);
+}
+
+std::vector<Move> SearchHandler::get_pv() const {
+    const auto& root_pv = pv_table.pv_array[PLY_OFFSET];
+    return std::vector<Move>(root_pv.begin() + PLY_OFFSET, root_pv.begin() + std::max(pv_table.pv_length[PLY_OFFSET], PLY_OFFSET));
+}
+
 void SearchHandler::run_perft(uint16_t depth) {
     search_cancelled = true;
     // cancel any existing search
@@ -87,78 +140,320 @@ void SearchHandler::reset() {
     board_hist = BoardHistory();
     tt.clear();
     history_table.clear();
+    pawn_table.clear();
+    eval_cache.clear();
+}
+
+BenchPositionResult SearchHandler::run_bench_position(const char* fen, uint16_t depth) {
+    std::unique_lock<std::mutex> lock(search_mutex);
+    this->reset();
+    Position pos;
+    pos.set_from_fen(fen);
+    this->set_pos(pos);
+    const auto start = std::chrono::steady_clock::now();
+    this->search(DepthTC{depth});
+    cv.wait(lock, [this] { return !this->is_searching(); });
+    // loop until search completes
+    const auto time_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    return BenchPositionResult{node_count, time_us, completed_depth, tt_hits, tt_probes};
 }
 
-void SearchHandler::run_bench(uint16_t depth) {
-    static constexpr std::array fens = {// taken from alexandria, originally from bitgenie
-                                        "r3k2r/2pb1ppp/2pp1q2/p7/1nP1B3/1P2P3/P2N1PPP/R2QK2R w KQkq a6 0 14",
-                                        "4rrk1/2p1b1p1/p1p3q1/4p3/2P2n1p/1P1NR2P/PB3PP1/3R1QK1 b - - 2 24",
-                                        "r3qbrk/6p1/2b2pPp/p3pP1Q/PpPpP2P/3P1B2/2PB3K/R5R1 w - - 16 42",
-                                        "6k1/1R3p2/6p1/2Bp3p/3P2q1/P7/1P2rQ1K/5R2 b - - 4 44",
-                                        "8/8/1p2k1p1/3p3p/1p1P1P1P/1P2PK2/8/8 w - - 3 54",
-                                        "7r/2p3k1/1p1p1qp1/1P1Bp3/p1P2r1P/P7/4R3/Q4RK1 w - - 0 36",
-                                        "r1bq1rk1/pp2b1pp/n1pp1n2/3P1p2/2P1p3/2N1P2N/PP2BPPP/R1BQ1RK1 b - - 2 10",
-                                        "3r3k/2r4p/1p1b3q/p4P2/P2Pp3/1B2P3/3BQ1RP/6K1 w - - 3 87",
-                                        "2r4r/1p4k1/1Pnp4/3Qb1pq/8/4BpPp/5P2/2RR1BK1 w - - 0 42",
-                                        "4q1bk/6b1/7p/p1p4p/PNPpP2P/KN4P1/3Q4/4R3 b - - 0 37",
-                                        "2q3r1/1r2pk2/pp3pp1/2pP3p/P1Pb1BbP/1P4Q1/R3NPP1/4R1K1 w - - 2 34",
-                                        "1r2r2k/1b4q1/pp5p/2pPp1p1/P3Pn2/1P1B1Q1P/2R3P1/4BR1K b - - 1 37",
-                                        "r3kbbr/pp1n1p1P/3ppnp1/q5N1/1P1pP3/P1N1B3/2P1QP2/R3KB1R b KQkq b3 0 17",
-                                        "8/6pk/2b1Rp2/3r4/1R1B2PP/P5K1/8/2r5 b - - 16 42",
-                                        "1r4k1/4ppb1/2n1b1qp/pB4p1/1n1BP1P1/7P/2PNQPK1/3RN3 w - - 8 29",
-                                        "8/p2B4/PkP5/4p1pK/4Pb1p/5P2/8/8 w - - 29 68",
-                                        "3r4/ppq1ppkp/4bnp1/2pN4/2P1P3/1P4P1/PQ3PBP/R4K2 b - - 2 20",
-                                        "5rr1/4n2k/4q2P/P1P2n2/3B1p2/4pP2/2N1P3/1RR1K2Q w - - 1 49",
-                                        "1r5k/2pq2p1/3p3p/p1pP4/4QP2/PP1R3P/6PK/8 w - - 1 51",
-                                        "q5k1/5ppp/1r3bn1/1B6/P1N2P2/BQ2P1P1/5K1P/8 b - - 2 34",
-                                        "r1b2k1r/5n2/p4q2/1ppn1Pp1/3pp1p1/NP2P3/P1PPBK2/1RQN2R1 w - - 0 22",
-                                        "r1bqk2r/pppp1ppp/5n2/4b3/4P3/P1N5/1PP2PPP/R1BQKB1R w KQkq - 0 5",
-                                        "r1bqr1k1/pp1p1ppp/2p5/8/3N1Q2/P2BB3/1PP2PPP/R3K2n b Q - 1 12",
-                                        "r1bq2k1/p4r1p/1pp2pp1/3p4/1P1B3Q/P2B1N2/2P3PP/4R1K1 b - - 2 19",
-                                        "r4qk1/6r1/1p4p1/2ppBbN1/1p5Q/P7/2P3PP/5RK1 w - - 2 25",
-                                        "r7/6k1/1p6/2pp1p2/7Q/8/p1P2K1P/8 w - - 0 32",
-                                        "r3k2r/ppp1pp1p/2nqb1pn/3p4/4P3/2PP4/PP1NBPPP/R2QK1NR w KQkq - 1 5",
-                                        "3r1rk1/1pp1pn1p/p1n1q1p1/3p4/Q3P3/2P5/PP1NBPPP/4RRK1 w - - 0 12",
-                                        "5rk1/1pp1pn1p/p3Brp1/8/1n6/5N2/PP3PPP/2R2RK1 w - - 2 20",
-                                        "8/1p2pk1p/p1p1r1p1/3n4/8/5R2/PP3PPP/4R1K1 b - - 3 27",
-                                        "8/4pk2/1p1r2p1/p1p4p/Pn5P/3R4/1P3PP1/4RK2 w - - 1 33",
-                                        "8/5k2/1pnrp1p1/p1p4p/P6P/4R1PK/1P3P2/4R3 b - - 1 38",
-                                        "8/8/1p1kp1p1/p1pr1n1p/P6P/1R4P1/1P3PK1/1R6 b - - 15 45",
-                                        "8/8/1p1k2p1/p1prp2p/P2n3P/6P1/1P1R1PK1/4R3 b - - 5 49",
-                                        "8/8/1p4p1/p1p2k1p/P2npP1P/4K1P1/1P6/3R4 w - - 6 54",
-                                        "8/8/1p4p1/p1p2k1p/P2n1P1P/4K1P1/1P6/6R1 b - - 6 59",
-                                        "8/5k2/1p4p1/p1pK3p/P2n1P1P/6P1/1P6/4R3 b - - 14 63",
-                                        "8/1R6/1p1K1kp1/p6p/P1p2P1P/6P1/1Pn5/8 w - - 0 67",
-                                        "1rb1rn1k/p3q1bp/2p3p1/2p1p3/2P1P2N/PP1RQNP1/1B3P2/4R1K1 b - - 4 23",
-                                        "4rrk1/pp1n1pp1/q5p1/P1pP4/2n3P1/7P/1P3PB1/R1BQ1RK1 w - - 3 22",
-                                        "r2qr1k1/pb1nbppp/1pn1p3/2ppP3/3P4/2PB1NN1/PP3PPP/R1BQR1K1 w - - 4 12",
-                                        "2r2k2/8/4P1R1/1p6/8/P4K1N/7b/2B5 b - - 0 55",
-                                        "6k1/5pp1/8/2bKP2P/2P5/p4PNb/B7/8 b - - 1 44",
-                                        "2rqr1k1/1p3p1p/p2p2p1/P1nPb3/2B1P3/5P2/1PQ2NPP/R1R4K w - - 3 25",
-                                        "r1b2rk1/p1q1ppbp/6p1/2Q5/8/4BP2/PPP3PP/2KR1B1R b - - 2 14",
-                                        "6r1/5k2/p1b1r2p/1pB1p1p1/1Pp3PP/2P1R1K1/2P2P2/3R4 w - - 1 36",
-                                        "rnbqkb1r/pppppppp/5n2/8/2PP4/8/PP2PPPP/RNBQKBNR b KQkq c3 0 2",
-                                        "2rr2k1/1p4bp/p1q1p1p1/4Pp1n/2PB4/1PN3P1/P3Q2P/2RR2K1 w - f6 0 20",
-                                        "3br1k1/p1pn3p/1p3n2/5pNq/2P1p3/1PN3PP/P2Q1PB1/4R1K1 w - - 0 23",
-                                        "2r2b2/5p2/5k2/p1r1pP2/P2pB3/1P3P2/K1P3R1/7R w - - 23 93",
-                                        "8/P6p/2K1q1pk/2Q5/4p3/8/7P/8 w - - 4 44",
-                                        "7k/8/7P/5B2/5K2/8/8/8 b - - 0 175"};
+std::optional<BenchSettings> parse_bench_args(const std::vector<std::string>& args) {
+    BenchSettings settings;
+    std::vector<std::string> positional;
+    for (size_t i = 0; i < args.size(); i++) {
+        if (args[i] == "--json") {
+            settings.json = true;
+        } else if (args[i] == "--repeat" && i + 1 < args.size()) {
+            const auto repetitions = parse_number<int>(args[++i]);
+            if (!repetitions.has_value() || *repetitions < 1) {
+                return std::nullopt;
+            }
+            settings.repetitions = *repetitions;
+        } else if (args[i].starts_with("-") || positional.size() == 3) {
+            return std::nullopt;
+        } else {
+            positional.push_back(args[i]);
+        }
+    }
+
+    if (positional.size() > 0) {
+        const auto depth = parse_number<int>(positional[0]);
+        if (!depth.has_value() || *depth < 1 || *depth > MAX_PLY - PLY_OFFSET) {
+            return std::nullopt;
+        }
+        settings.depth = *depth;
+    }
+    if (positional.size() > 1) {
+        const auto threads = parse_number<int>(positional[1]);
+        if (!threads.has_value() || *threads < 1) {
+            return std::nullopt;
+        }
+        settings.threads = *threads;
+    }
+    if (positional.size() > 2) {
+        const auto hash_mb = parse_number<size_t>(positional[2]);
+        if (!hash_mb.has_value() || *hash_mb < 1) {
+            return std::nullopt;
+        }
+        settings.hash_mb = *hash_mb;
+    }
+    return settings;
+}
+
+void SearchHandler::run_bench(uint16_t depth, bool json, int repetitions) {
     print_info = false;
+    if (json) {
+        run_json_bench(depth, repetitions);
+        return;
+    }
     uint64_t total_nodes = 0;
+    uint64_t pawn_hits = 0, pawn_probes = 0, eval_hits = 0, eval_probes = 0;
+    SearchStats total_stats;
     const auto start = std::chrono::steady_clock::now();
-    for (const auto& fen : fens) {
-        std::unique_lock<std::mutex> lock(search_mutex);
-        this->reset();
-        Position pos;
-        pos.set_from_fen(fen);
-        this->set_pos(pos);
-        this->search(DepthTC{depth});
-        cv.wait(lock, [this] { return !this->is_searching(); });
-        // loop until search completes
-        total_nodes += node_count;
-        std::cout << fen << " " << node_count << std::endl;
+    for (const auto& fen : bench_fens) {
+        const auto result = run_bench_position(fen, depth);
+        total_nodes += result.nodes;
+        total_stats += stats;
+        pawn_hits += pawn_table.hits();
+        pawn_probes += pawn_table.hits() + pawn_table.misses();
+        eval_hits += eval_cache.hits();
+        eval_probes += eval_cache.hits() + eval_cache.misses();
+        std::cout << fen << " " << result.nodes << std::endl;
     }
     const auto duration =
         std::max(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count(), (int64_t) 1);
+    total_stats.print();
+    std::cout << "pawn table hit rate: " << (100.0 * pawn_hits / std::max(pawn_probes, (uint64_t) 1)) << "%" << std::endl;
+    std::cout << "eval cache hit rate: " << (100.0 * eval_hits / std::max(eval_probes, (uint64_t) 1)) << "%" << std::endl;
     std::cout << total_nodes << " nodes " << (total_nodes / duration) * 1000 << " nps" << std::endl;
-}
\ No newline at end of file
+}
+
+namespace {
+
+double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    const auto middle = values.size() / 2;
+    return (values.size() % 2 == 1) ? values[middle] : (values[middle - 1] + values[middle]) / 2;
+}
+
+double standard_deviation(const std::vector<double>& values) {
+    if (values.size() < 2) {
+        return 0;
+    }
+    const auto mean = std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+    const auto squares = std::accumulate(values.begin(), values.end(), 0.0, [&](double total, double v) { return total + (v - mean) * (v - mean); });
+    return std::sqrt(squares / (values.size() - 1));
+}
+
+double nps(uint64_t nodes, int64_t time_us) { return nodes * 1000000.0 / std::max(time_us, (int64_t) 1); }
+
+} // namespace
+
+/**
+ * @brief Runs the bench several times and writes the results as a single JSON object.  Node counts and depths are the same on every
+ * repetition, so only the timings are summarised across repetitions, by their median and sample standard deviation, so that a regression
+ * can be told apart from noise between runs
+ */
+void SearchHandler::run_json_bench(uint16_t depth, int repetitions) {
+    repetitions = std::max(repetitions, 1);
+    // results[repetition][position]
+    std::vector<std::vector<BenchPositionResult>> results(repetitions);
+    for (auto& repetition : results) {
+        for (const auto& fen : bench_fens) {
+            repetition.push_back(run_bench_position(fen, depth));
+        }
+    }
+
+    printf("{\n  \"depth\": %d,\n  \"repetitions\": %d,\n  \"positions\": [\n", depth, repetitions);
+    std::vector<double> total_times(repetitions, 0);
+    uint64_t total_nodes = 0, total_tt_hits = 0, total_tt_probes = 0;
+    for (size_t i = 0; i < bench_fens.size(); i++) {
+        const auto& result = results[0][i];
+        std::vector<double> times, speeds;
+        for (int r = 0; r < repetitions; r++) {
+            times.push_back(results[r][i].time_us / 1000.0);
+            speeds.push_back(nps(results[r][i].nodes, results[r][i].time_us));
+            total_times[r] += results[r][i].time_us;
+        }
+        total_nodes += result.nodes;
+        total_tt_hits += result.tt_hits;
+        total_tt_probes += result.tt_probes;
+        printf("    {\"fen\": \"%s\", \"nodes\": %lu, \"depth\": %d, \"time_ms\": %.3f, \"time_ms_stddev\": %.3f, \"nps\": %.0f, "
+               "\"nps_stddev\": %.0f, \"tt_hit_rate\": %.4f}%s\n",
+               bench_fens[i], result.nodes, result.depth, median(times), standard_deviation(times), median(speeds), standard_deviation(speeds),
+               static_cast<double>(result.tt_hits) / std::max(result.tt_probes, (uint64_t) 1), (i + 1 < bench_fens.size()) ? "," : "");
+    }
+
+    // the process's high-water mark, which can't be attributed to any one position, as the table is allocated before the first of them
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    std::vector<double> total_speeds;
+    for (auto& time : total_times) {
+        total_speeds.push_back(nps(total_nodes, time));
+        time /= 1000;
+    }
+    printf("  ],\n  \"total\": {\"nodes\": %lu, \"time_ms\": %.3f, \"time_ms_stddev\": %.3f, \"nps\": %.0f, \"nps_stddev\": %.0f, "
+           "\"tt_hit_rate\": %.4f, \"peak_rss_kb\": %ld}\n}\n",
+           total_nodes, median(total_times), standard_deviation(total_times), median(total_speeds), standard_deviation(total_speeds),
+           static_cast<double>(total_tt_hits) / std::max(total_tt_probes, (uint64_t) 1), usage.ru_maxrss);
+    fflush(stdout);
+}
+
+namespace {
+
+struct SmpBenchPosition {
+    int64_t time_us;
+    std::vector<uint64_t> thread_nodes;
+};
+
+/**
+ * @brief Searches every bench position to the given depth with one handler per thread, all sharing one transposition table.  The first
+ * handler is the main thread; the rest are lazy SMP helpers that only contribute through the table and are stopped as soon as the main
+ * thread reaches the depth, so the time recorded is the main thread's time to depth.  Helper i starts iterative deepening at depth
+ * i + 1, so that the helpers search ahead of the main thread and of each other rather than repeating its iterations
+ */
+std::vector<SmpBenchPosition> run_smp_bench_positions(uint16_t depth, int threads, size_t hash_mb) {
+    TranspositionTable table;
+    table.resize(hash_mb);
+    std::vector<std::unique_ptr<SearchHandler>> handlers;
+    for (int i = 0; i < threads; i++) {
+        handlers.push_back(std::make_unique<SearchHandler>(table));
+        handlers.back()->set_print_info(false);
+        handlers.back()->set_start_depth(std::min(i + 1, static_cast<int>(depth)));
+    }
+
+    std::vector<SmpBenchPosition> results;
+    for (const auto& fen : bench_fens) {
+        Position pos;
+        pos.set_from_fen(fen);
+        table.clear();
+        for (auto& handler : handlers) {
+            handler->reset();
+            handler->set_pos(pos);
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<std::future<void>> helpers;
+        for (int i = 1; i < threads; i++) {
+            helpers.push_back(std::async(std::launch::async, [&, i] { handlers[i]->search_sync(DepthTC{depth}); }));
+        }
+        handlers[0]->search_sync(DepthTC{depth});
+        const auto time_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        for (size_t i = 0; i < helpers.size(); i++) {
+            // a helper that hadn't yet started when it was first stopped clears the flag, so keep stopping it until it returns
+            do {
+                handlers[i + 1]->EndSearch();
+            } while (helpers[i].wait_for(std::chrono::milliseconds(1)) != std::future_status::ready);
+        }
+
+        SmpBenchPosition result{time_us, {}};
+        for (auto& handler : handlers) {
+            result.thread_nodes.push_back(handler->get_node_count());
+        }
+        results.push_back(result);
+    }
+    return results;
+}
+
+} // namespace
+
+/**
+ * @brief Runs the bench with a shared transposition table of the given size on the given number of threads, comparing the time to depth
+ * against a single thread searching with the same table size
+ */
+SmpBenchSummary SearchHandler::run_smp_bench(uint16_t depth, int threads, size_t hash_mb) {
+    threads = std::max(threads, 1);
+    const auto single = run_smp_bench_positions(depth, 1, hash_mb);
+    const auto multi = (threads == 1) ? single : run_smp_bench_positions(depth, threads, hash_mb);
+
+    SmpBenchSummary summary;
+    summary.thread_nodes.resize(threads, 0);
+    for (size_t i = 0; i < bench_fens.size(); i++) {
+        const auto nodes = std::accumulate(multi[i].thread_nodes.begin(), multi[i].thread_nodes.end(), (uint64_t) 0);
+        printf("%s %lu nodes %.1f ms, %.2fx speedup\n", bench_fens[i], nodes, multi[i].time_us / 1000.0,
+               static_cast<double>(single[i].time_us) / std::max(multi[i].time_us, (int64_t) 1));
+        summary.position_nodes.push_back(nodes);
+        summary.single_time_us += single[i].time_us;
+        summary.multi_time_us += multi[i].time_us;
+        summary.total_nodes += nodes;
+        for (int t = 0; t < threads; t++) {
+            summary.thread_nodes[t] += multi[i].thread_nodes[t];
+        }
+    }
+
+    for (int t = 0; t < threads; t++) {
+        printf("thread %d: %lu nodes (%.1f%%)%s\n", t, summary.thread_nodes[t],
+               100.0 * summary.thread_nodes[t] / std::max(summary.total_nodes, (uint64_t) 1),
+               t == 0 ? ", main" : (", helper starting at depth " + std::to_string(std::min(t + 1, static_cast<int>(depth)))).c_str());
+    }
+    printf("time to depth %d: %.1f ms on 1 thread, %.1f ms on %d threads, %.2fx speedup\n", depth, summary.single_time_us / 1000.0,
+           summary.multi_time_us / 1000.0, threads, static_cast<double>(summary.single_time_us) / std::max(summary.multi_time_us, (int64_t) 1));
+    printf("%lu nodes %lu nps\n", summary.total_nodes,
+           static_cast<uint64_t>(summary.total_nodes * 1000000.0 / std::max(summary.multi_time_us, (int64_t) 1)));
+    fflush(stdout);
+    return summary;
+}
+
+void SearchHandler::run_movegen_bench(uint32_t iterations) {
+    std::vector<Position> positions(bench_fens.size());
+    for (size_t i = 0; i < bench_fens.size(); i++) {
+        positions[i].set_from_fen(bench_fens[i]);
+    }
+
+    const auto time_generation = [&](auto generate) {
+        uint64_t total_moves = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < iterations; i++) {
+            for (const auto& pos : positions) {
+                total_moves += generate(pos).size();
+            }
+        }
+        const auto duration = std::max(
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count(), (int64_t) 1);
+        return std::make_pair(total_moves, static_cast<uint64_t>(total_moves * 1000000 / duration));
+    };
+
+    const auto [legal_moves, legal_mps] = time_generation([](const Position& pos) {
+        return MoveGenerator::generate_legal_moves<MoveGenType::ALL_LEGAL>(pos, pos.stm());
+    });
+    std::cout << "all legal: " << legal_moves << " moves " << legal_mps << " moves/s" << std::endl;
+    const auto [noisy_moves, noisy_mps] = time_generation([](const Position& pos) {
+        return MoveGenerator::generate_legal_moves<MoveGenType::QUIESCENCE>(pos, pos.stm());
+    });
+    std::cout << "quiescence: " << noisy_moves << " moves " << noisy_mps << " moves/s" << std::endl;
+}
+
+void SearchHandler::run_eval_bench(uint32_t iterations) {
+    // the bench positions and all of their children, so that consecutive evaluations share pawn structures as they do in search
+    std::vector<Position> positions;
+    for (const auto& fen : bench_fens) {
+        Position pos;
+        pos.set_from_fen(fen);
+        positions.push_back(pos);
+        const auto moves = MoveGenerator::generate_legal_moves<MoveGenType::ALL_LEGAL>(pos, pos.stm());
+        for (size_t i = 0; i < moves.size(); i++) {
+            positions.emplace_back(pos, moves[i].move);
+        }
+    }
+
+    const auto time_evaluation = [&](auto evaluate) {
+        int64_t checksum = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < iterations; i++) {
+            for (const auto& pos : positions) {
+                checksum += evaluate(pos);
+            }
+        }
+        const auto duration = std::max(
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count(), (int64_t) 1);
+        return std::make_pair(checksum, static_cast<uint64_t>(iterations * positions.size() * 1000000 / duration));
+    };
+
+    const auto [uncached_sum, uncached_eps] = time_evaluation([](const Position& pos) { return Evaluation::evaluate_board(pos); });
+    std::cout << "uncached: " << uncached_eps << " evals/s (checksum " << uncached_sum << ")" << std::endl;
+    PawnTable pawn_table;
+    const auto [cached_sum, cached_eps] = time_evaluation([&](const Position& pos) { return Evaluation::evaluate_board(pos, pawn_table); });
+    std::cout << "pawn table: " << cached_eps << " evals/s (checksum " << cached_sum << "), "
+              << (100.0 * pawn_table.hits() / std::max(pawn_table.hits() + pawn_table.misses(), (uint64_t) 1)) << "% hit rate" << std::endl;
+}
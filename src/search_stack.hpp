@@ -0,0 +1,26 @@
+#pragma once
+
+#include "magic_numbers.hpp"
+#include "move.hpp"
+#include "pieces.hpp"
+
+/**
+ * @brief Per-ply search state.  Each node fills in its own frame, so later plies can read what happened further up the current line
+ * without going back to the positions in BoardHistory.  The root is at PLY_OFFSET, so the frames below it are always valid to read; the one
+ * directly below the root holds the last move played in the game
+ */
+struct SearchStackFrame {
+    Move killer_move = Move::NULL_MOVE();
+    // the corrected static eval of this ply's position, or negative infinity if it was in check
+    Score static_eval = MagicNumbers::NegativeInfinity;
+    // the move currently being searched from this ply, which is the null move during null move pruning
+    Move current_move = Move::NULL_MOVE();
+    Piece moved_piece;
+    bool in_check = false;
+    // how far the current move's search was reduced by LMR
+    int reduction = 0;
+    // the move skipped by a singular extension's verification search of this ply's position, or the null move outside of one
+    Move excluded_move = Move::NULL_MOVE();
+
+    int piece_to() const { return (moved_piece.get_value() << 6) | sq_to_int(current_move.dst_sq()); };
+};
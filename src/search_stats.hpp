@@ -0,0 +1,109 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+
+enum class SearchStat {
+    NODE,
+    QSEARCH_NODE,
+    TT_HIT,
+    TT_CUTOFF,
+    RFP_PRUNE,
+    RAZOR_PRUNE,
+    NMP_ATTEMPT,
+    NMP_CUTOFF,
+    SINGULAR_SEARCH,
+    SINGULAR_EXTENSION,
+    MULTI_CUT,
+    LMP_PRUNE,
+    FUTILITY_PRUNE,
+    HISTORY_PRUNE,
+    SEE_PRUNE,
+    LMR_SEARCH,
+    LMR_RESEARCH,
+    FAIL_HIGH,
+    FIRST_MOVE_FAIL_HIGH,
+    COUNT,
+};
+
+#ifdef SEARCH_STATS
+constexpr bool search_stats_enabled = true;
+#else
+constexpr bool search_stats_enabled = false;
+#endif
+
+template <bool enabled> class BasicSearchStats;
+
+/**
+ * @brief The counters of a normal build, where every call is empty so that the search compiles exactly as if they weren't there
+ */
+template <> class BasicSearchStats<false> {
+    public:
+        void add(SearchStat, int) {};
+        void clear() {};
+        void print() const {};
+        BasicSearchStats& operator+=(const BasicSearchStats&) { return *this; };
+};
+
+/**
+ * @brief Counts what the search did at each remaining depth, to explain why node counts change between builds.  Only compiled in with
+ * -DSEARCH_STATS; quiescence search is counted at depth 0 and anything deeper than the table is counted in its last row
+ */
+template <> class BasicSearchStats<true> {
+    private:
+        static constexpr int MaxDepth = 64;
+        std::array<std::array<uint64_t, static_cast<size_t>(SearchStat::COUNT)>, MaxDepth> counts = {};
+
+        uint64_t get(int depth, SearchStat stat) const { return counts[depth][static_cast<size_t>(stat)]; };
+        static double percent(uint64_t count, uint64_t total) { return 100.0 * count / std::max(total, (uint64_t) 1); };
+
+    public:
+        void add(SearchStat stat, int depth) { counts[std::clamp(depth, 0, MaxDepth - 1)][static_cast<size_t>(stat)] += 1; };
+        void clear() { counts = {}; };
+
+        BasicSearchStats& operator+=(const BasicSearchStats& other) {
+            for (int depth = 0; depth < MaxDepth; depth++) {
+                for (size_t stat = 0; stat < counts[depth].size(); stat++) {
+                    counts[depth][stat] += other.counts[depth][stat];
+                }
+            }
+            return *this;
+        }
+
+        void print() const {
+            printf("info string depth      nodes  tt hit  tt cut      rfp    razor      nmp  nmp cut       se      ext     mcut      lmp       fp"
+                   "       hp      see      lmr lmr re-search first move cut\n");
+            std::array<uint64_t, static_cast<size_t>(SearchStat::COUNT)> totals = {};
+            for (int depth = MaxDepth - 1; depth >= 1; depth--) {
+                const auto nodes = get(depth, SearchStat::NODE);
+                if (nodes == 0) {
+                    continue;
+                }
+                for (size_t stat = 0; stat < totals.size(); stat++) {
+                    totals[stat] += counts[depth][stat];
+                }
+                printf("info string %5d %10lu %6.1f%% %6.1f%% %8lu %8lu %8lu %7.1f%% %8lu %8lu %8lu %8lu %8lu %8lu %8lu %8lu %12.1f%% %13.1f%%\n",
+                       depth, nodes, percent(get(depth, SearchStat::TT_HIT), nodes), percent(get(depth, SearchStat::TT_CUTOFF), nodes),
+                       get(depth, SearchStat::RFP_PRUNE), get(depth, SearchStat::RAZOR_PRUNE), get(depth, SearchStat::NMP_ATTEMPT),
+                       percent(get(depth, SearchStat::NMP_CUTOFF), get(depth, SearchStat::NMP_ATTEMPT)), get(depth, SearchStat::SINGULAR_SEARCH),
+                       get(depth, SearchStat::SINGULAR_EXTENSION), get(depth, SearchStat::MULTI_CUT), get(depth, SearchStat::LMP_PRUNE),
+                       get(depth, SearchStat::FUTILITY_PRUNE), get(depth, SearchStat::HISTORY_PRUNE), get(depth, SearchStat::SEE_PRUNE),
+                       get(depth, SearchStat::LMR_SEARCH), percent(get(depth, SearchStat::LMR_RESEARCH), get(depth, SearchStat::LMR_SEARCH)),
+                       percent(get(depth, SearchStat::FIRST_MOVE_FAIL_HIGH), get(depth, SearchStat::FAIL_HIGH)));
+            }
+            const auto total = [&](SearchStat stat) { return totals[static_cast<size_t>(stat)]; };
+            const auto qnodes = get(0, SearchStat::QSEARCH_NODE);
+            printf("info string total %lu nodes, qsearch %lu (%.1f%%), tt hits %.1f%%, nmp cutoffs %.1f%%, lmr re-searches %.1f%%, first move "
+                   "fail highs %.1f%%\n",
+                   total(SearchStat::NODE) + qnodes, qnodes, percent(qnodes, total(SearchStat::NODE) + qnodes),
+                   percent(total(SearchStat::TT_HIT) + get(0, SearchStat::TT_HIT), total(SearchStat::NODE) + qnodes),
+                   percent(total(SearchStat::NMP_CUTOFF), total(SearchStat::NMP_ATTEMPT)),
+                   percent(total(SearchStat::LMR_RESEARCH), total(SearchStat::LMR_SEARCH)),
+                   percent(total(SearchStat::FIRST_MOVE_FAIL_HIGH), total(SearchStat::FAIL_HIGH)));
+            fflush(stdout);
+        }
+};
+
+using SearchStats = BasicSearchStats<search_stats_enabled>;
@@ -0,0 +1,159 @@
+#include "search_trace.hpp"
+
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/**
+ * @brief Creates or truncates the trace file at path with room for capacity records, and starts writing to it
+ */
+bool BasicSearchTracer<true>::open(const std::string& path, uint64_t capacity) {
+    close();
+    if (path.empty() || capacity == 0) {
+        return false;
+    }
+    const auto size = sizeof(TraceHeader) + capacity * sizeof(TraceRecord);
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    void* mapping = MAP_FAILED;
+    if (ftruncate(fd, size) == 0) {
+        mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    if (mapping == MAP_FAILED) {
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+    header = static_cast<TraceHeader*>(mapping);
+    std::memcpy(header->magic, trace_magic, sizeof(trace_magic));
+    header->capacity = capacity;
+    header->written = 0;
+    records = reinterpret_cast<TraceRecord*>(header + 1);
+    return true;
+}
+
+void BasicSearchTracer<true>::close() {
+    if (header != nullptr) {
+        munmap(header, sizeof(TraceHeader) + header->capacity * sizeof(TraceRecord));
+        ::close(fd);
+    }
+    fd = -1;
+    header = nullptr;
+    records = nullptr;
+}
+
+const char* TraceReader::event_name(TraceEvent event) {
+    constexpr std::array<const char*, static_cast<size_t>(TraceEvent::COUNT)> names = {
+        "searched", "qsearched", "stand pat", "draw",  "tt cutoff",    "max ply",  "rfp",     "razor", "nmp",
+        "multi-cut", "checkmate", "stalemate", "singular verification", "lmp pruned", "fp pruned", "hp pruned", "see pruned",
+    };
+    const auto index = static_cast<size_t>(event);
+    return index < names.size() ? names[index] : "unknown";
+}
+
+bool is_pruned_move(TraceEvent event) {
+    return event == TraceEvent::LMP || event == TraceEvent::FUTILITY || event == TraceEvent::HISTORY || event == TraceEvent::SEE;
+}
+
+struct TraceNode {
+    TraceRecord record;
+    std::vector<size_t> children;
+};
+
+std::string trace_move_string(const TraceRecord& record) {
+    const Move move(record.move);
+    return move.is_null_move() ? "null" : move.to_string();
+}
+
+void print_trace_node(const std::vector<TraceNode>& nodes, size_t index, int indent, int plies_left) {
+    const auto& record = nodes[index].record;
+    constexpr std::array<const char*, 3> node_type_names = {"root", "pv", "non-pv"};
+    printf("%*s%s", indent * 2, "", trace_move_string(record).c_str());
+    if (is_pruned_move(record.event)) {
+        printf(" %s at depth %d [%d, %d]\n", TraceReader::event_name(record.event), record.depth + 1, record.alpha, record.beta);
+        return;
+    }
+    printf(" depth %d %s [%d, %d] score %d %s, node %lu", record.depth, node_type_names[std::min<size_t>(record.node_type, 2)],
+           record.alpha, record.beta, record.score, TraceReader::event_name(record.event), record.node);
+    if (plies_left == 0 && !nodes[index].children.empty()) {
+        printf(", %zu children not shown", nodes[index].children.size());
+    }
+    printf("\n");
+    if (plies_left > 0) {
+        for (const auto child : nodes[index].children) {
+            print_trace_node(nodes, child, indent + 1, plies_left - 1);
+        }
+    }
+}
+
+/**
+ * @brief Rebuilds the search tree from a trace file and prints it under every root search that traced root_move, down to
+ * max_plies below the root move.  Without a root move, every root move is printed on one line.  Subtrees whose records were
+ * overwritten by the ring buffer, or that fell outside the node window, are printed with whatever children are left
+ */
+int TraceReader::print_tree(const std::string& path, const std::string& root_move, int max_plies) {
+    std::ifstream file(path, std::ios::binary);
+    TraceHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || std::memcmp(header.magic, trace_magic, sizeof(trace_magic)) != 0
+        || header.capacity == 0) {
+        printf("%s is not a search trace\n", path.c_str());
+        return 1;
+    }
+    std::vector<TraceRecord> ring(header.capacity);
+    file.read(reinterpret_cast<char*>(ring.data()), header.capacity * sizeof(TraceRecord));
+    const auto count = std::min(header.written, header.capacity);
+    printf("%lu records written, %lu kept\n", header.written, count);
+
+    // each node's children are the nodes one ply deeper that returned since the last node at its own ply, except that a singular
+    // verification search is made from the node's own position and so is at the same ply as it
+    std::vector<TraceNode> nodes;
+    nodes.reserve(count);
+    std::array<std::vector<size_t>, MAX_PLY + 2> pending;
+    std::vector<size_t> roots;
+    for (uint64_t i = header.written - count; i < header.written; i++) {
+        const auto& record = ring[i % header.capacity];
+        const auto index = nodes.size();
+        const auto ply = std::min<size_t>(record.ply, MAX_PLY);
+        nodes.push_back({record, {}});
+        if (!is_pruned_move(record.event)) {
+            auto& children = nodes[index].children;
+            if (record.event != TraceEvent::SINGULAR_VERIFICATION) {
+                while (!pending[ply].empty() && nodes[pending[ply].back()].record.event == TraceEvent::SINGULAR_VERIFICATION) {
+                    children.insert(children.begin(), pending[ply].back());
+                    pending[ply].pop_back();
+                }
+            }
+            children.insert(children.end(), pending[ply + 1].begin(), pending[ply + 1].end());
+            pending[ply + 1].clear();
+        }
+        if (ply == PLY_OFFSET && record.event != TraceEvent::SINGULAR_VERIFICATION && !is_pruned_move(record.event)) {
+            roots.push_back(index);
+        } else {
+            pending[ply].push_back(index);
+        }
+    }
+
+    for (const auto root : roots) {
+        const auto& record = nodes[root].record;
+        printf("root search depth %d [%d, %d] score %d, node %lu\n", record.depth, record.alpha, record.beta, record.score, record.node);
+        for (const auto child : nodes[root].children) {
+            if (root_move.empty()) {
+                print_trace_node(nodes, child, 1, 0);
+            } else if (trace_move_string(nodes[child].record) == root_move) {
+                print_trace_node(nodes, child, 1, max_plies);
+            }
+        }
+    }
+    if (roots.empty()) {
+        printf("no root searches were traced; widen the node window to include the end of a search\n");
+    }
+    return 0;
+}
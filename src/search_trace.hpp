@@ -0,0 +1,133 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+#include "move.hpp"
+#include "utils.hpp"
+
+/**
+ * @brief Why a node returned, or for a move that was never searched, which pruning skipped it
+ */
+enum class TraceEvent : uint8_t {
+    SEARCHED,
+    QSEARCHED,
+    STAND_PAT,
+    DRAW,
+    TT_CUTOFF,
+    MAX_PLY,
+    RFP,
+    RAZOR,
+    NMP,
+    MULTI_CUT,
+    CHECKMATE,
+    STALEMATE,
+    SINGULAR_VERIFICATION,
+    LMP,
+    FUTILITY,
+    HISTORY,
+    SEE,
+    COUNT,
+};
+
+/**
+ * @brief One node of the search, written as it returns so that a node's children always come before it.  Pruned moves are written
+ * as a record at the child's ply with the event that pruned them and no score
+ */
+struct TraceRecord {
+    uint64_t node;
+    Score alpha;
+    Score beta;
+    Score score;
+    uint16_t move;
+    uint8_t ply;
+    int8_t depth;
+    uint8_t node_type;
+    TraceEvent event;
+    uint8_t padding[2];
+};
+static_assert(sizeof(TraceRecord) == 24);
+
+/**
+ * @brief The start of a trace file, which is followed by capacity records.  Once more than capacity records have been written the
+ * oldest are overwritten, so record i lives at index i % capacity
+ */
+struct TraceHeader {
+    char magic[8];
+    uint64_t capacity;
+    uint64_t written;
+};
+
+constexpr char trace_magic[8] = {'C', 'H', 'S', 'T', 'R', 'C', '0', '1'};
+constexpr uint64_t default_trace_capacity = 1 << 22;
+
+#ifdef SEARCH_TRACE
+constexpr bool search_trace_enabled = true;
+#else
+constexpr bool search_trace_enabled = false;
+#endif
+
+template <bool enabled> class BasicSearchTracer;
+
+/**
+ * @brief The tracer of a normal build, where every call is empty so that the search compiles exactly as if it wasn't there
+ */
+template <> class BasicSearchTracer<false> {
+    public:
+        bool open(const std::string&, uint64_t = default_trace_capacity) { return false; };
+        void close() {};
+        void set_window(uint64_t, uint64_t) {};
+        void record(uint64_t, int, int, Score, Score, Score, Move, uint8_t, TraceEvent) {};
+};
+
+/**
+ * @brief Writes the search tree to a memory-mapped ring buffer for the trace command to rebuild.  Only compiled in with -DSEARCH_TRACE;
+ * records are only written while the node count is inside the window, so that tracing a long search costs a comparison per node
+ * outside of the part being looked at
+ */
+template <> class BasicSearchTracer<true> {
+    private:
+        int fd = -1;
+        TraceHeader* header = nullptr;
+        TraceRecord* records = nullptr;
+        uint64_t window_start = 0;
+        uint64_t window_end = UINT64_MAX;
+
+    public:
+        BasicSearchTracer() = default;
+        BasicSearchTracer(const BasicSearchTracer&) = delete;
+        BasicSearchTracer& operator=(const BasicSearchTracer&) = delete;
+        ~BasicSearchTracer() { close(); };
+
+        bool open(const std::string& path, uint64_t capacity = default_trace_capacity);
+        void close();
+        void set_window(uint64_t start, uint64_t end) {
+            window_start = start;
+            window_end = end;
+        };
+
+        void record(uint64_t node, int ply, int depth, Score alpha, Score beta, Score score, Move move, uint8_t node_type, TraceEvent event) {
+            if (records == nullptr || node < window_start || node >= window_end) {
+                return;
+            }
+            records[header->written % header->capacity] = {node,
+                                                          alpha,
+                                                          beta,
+                                                          score,
+                                                          move.value(),
+                                                          static_cast<uint8_t>(ply),
+                                                          static_cast<int8_t>(std::clamp(depth, -128, 127)),
+                                                          node_type,
+                                                          event,
+                                                          {}};
+            header->written += 1;
+        };
+};
+
+using SearchTracer = BasicSearchTracer<search_trace_enabled>;
+
+namespace TraceReader {
+    const char* event_name(TraceEvent event);
+    int print_tree(const std::string& path, const std::string& root_move, int max_plies);
+} // namespace TraceReader
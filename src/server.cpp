@@ -0,0 +1,340 @@
+#include "server.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "uci.hpp"
+
+enum class SessionState {
+    IDLE,
+    QUEUED,
+    SEARCHING,
+};
+
+/**
+ * @brief One connection.  The reader thread owns the session, while the state, position and go command are shared with whichever
+ * worker picks up its search, under the session's mutex
+ */
+struct Server::Session {
+    int fd;
+    std::thread reader;
+    std::atomic<bool> finished = false;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    SessionState state = SessionState::IDLE;
+    // both are checked when the command arrives, so that a worker only ever sees commands it can run
+    PositionCommand position = *parse_position_command("position startpos");
+    TimeControlInfo limits;
+    SearchHandler* running_on = nullptr;
+    bool closed = false;
+
+    std::mutex write_mutex;
+
+    explicit Session(int fd) : fd(fd) {}
+
+    void write(const std::string& data) {
+        std::lock_guard<std::mutex> lock(write_mutex);
+        for (size_t written = 0; written < data.size();) {
+            // the client may have gone away mid-search, which must not raise SIGPIPE
+            const auto sent = send(fd, data.data() + written, data.size() - written, MSG_NOSIGNAL);
+            if (sent <= 0) {
+                return;
+            }
+            written += sent;
+        }
+    }
+};
+
+Server::UciServer::UciServer(const Settings& settings) : settings(settings) {
+    table.resize(std::max(settings.hash_mb, (size_t) 1));
+}
+
+bool Server::UciServer::start() {
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (settings.socket_path.empty() || settings.socket_path.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    std::strcpy(address.sun_path, settings.socket_path.c_str());
+    listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0) {
+        return false;
+    }
+    // a socket file left behind by a server that didn't shut down cleanly would make the bind fail
+    unlink(settings.socket_path.c_str());
+    if (bind(listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listen_fd, SOMAXCONN) != 0) {
+        close(listen_fd);
+        listen_fd = -1;
+        return false;
+    }
+
+    for (int i = 0; i < std::max(settings.workers, 1); i++) {
+        handlers.push_back(std::make_unique<SearchHandler>(table));
+        handlers.back()->set_print_info(true);
+    }
+    for (auto& handler : handlers) {
+        workers.emplace_back(&UciServer::run_worker, this, std::ref(*handler));
+    }
+    acceptor = std::thread(&UciServer::accept_connections, this);
+    return true;
+}
+
+/**
+ * @brief Stops accepting connections, ends every session and its search, and returns once everything has shut down
+ */
+void Server::UciServer::stop() {
+    if (!stopping.exchange(true) && listen_fd >= 0) {
+        // wakes the acceptor from accept, after which it shuts everything else down
+        shutdown(listen_fd, SHUT_RDWR);
+    }
+    wait();
+}
+
+void Server::UciServer::wait() {
+    std::lock_guard<std::mutex> lock(join_mutex);
+    if (acceptor.joinable()) {
+        acceptor.join();
+    }
+}
+
+void Server::UciServer::accept_connections() {
+    while (true) {
+        const int fd = accept(listen_fd, nullptr, nullptr);
+        if (stopping) {
+            if (fd >= 0) {
+                close(fd);
+            }
+            break;
+        }
+        if (fd < 0) {
+            continue;
+        }
+        close_finished_sessions(false);
+        auto session = std::make_shared<Session>(fd);
+        std::lock_guard<std::mutex> lock(sessions_mutex);
+        sessions.push_back(session);
+        session->reader = std::thread(&UciServer::run_session, this, session);
+    }
+
+    // sessions go first, as a session waits for its search to finish before it ends, and only then the workers
+    {
+        std::lock_guard<std::mutex> lock(sessions_mutex);
+        for (auto& session : sessions) {
+            shutdown(session->fd, SHUT_RDWR);
+        }
+    }
+    close_finished_sessions(true);
+    {
+        std::lock_guard<std::mutex> lock(jobs_mutex);
+        workers_stopping = true;
+    }
+    jobs_cv.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+    close(listen_fd);
+    listen_fd = -1;
+    unlink(settings.socket_path.c_str());
+}
+
+/**
+ * @brief Joins and closes sessions whose clients have disconnected, or every session if all is set.  A session's socket is only closed
+ * here, so that the descriptor can't be reused while the server might still shut it down
+ */
+void Server::UciServer::close_finished_sessions(bool all) {
+    std::lock_guard<std::mutex> lock(sessions_mutex);
+    std::erase_if(sessions, [all](const std::shared_ptr<Session>& session) {
+        if (!all && !session->finished) {
+            return false;
+        }
+        session->reader.join();
+        close(session->fd);
+        return true;
+    });
+}
+
+void Server::UciServer::run_session(std::shared_ptr<Session> session) {
+    std::string buffer;
+    char data[4096];
+    bool quit = false;
+    while (!quit) {
+        const auto received = recv(session->fd, data, sizeof(data), 0);
+        if (received <= 0) {
+            break;
+        }
+        buffer.append(data, received);
+        for (auto end = buffer.find('\n'); end != std::string::npos && !quit; end = buffer.find('\n')) {
+            auto line = buffer.substr(0, end);
+            buffer.erase(0, end + 1);
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            const auto parsed_line = split_on_whitespace(line);
+            if (parsed_line.empty()) {
+                continue;
+            }
+            const auto& command = parsed_line[0];
+            if (command == "uci") {
+                session->write("id name Chessatron\nuciok\n");
+            } else if (command == "isready") {
+                session->write("readyok\n");
+            } else if (command == "position") {
+                const auto position = parse_position_command(line);
+                if (!position.has_value()) {
+                    // the last good position stays, as it would have with a GUI that never sent this
+                    session->write("info string error: invalid position command\n");
+                    continue;
+                }
+                std::lock_guard<std::mutex> lock(session->mutex);
+                session->position = *position;
+            } else if (command == "go") {
+                queue_search(session, parsed_line);
+            } else if (command == "stop") {
+                stop_search(*session);
+            } else if (command == "quit") {
+                quit = true;
+            }
+            // the table is shared by every session, so ucinewgame can't clear it, and options are set for the whole server
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(session->mutex);
+        session->closed = true;
+    }
+    stop_search(*session);
+    std::unique_lock<std::mutex> lock(session->mutex);
+    session->cv.wait(lock, [&] { return session->state == SessionState::IDLE; });
+    session->finished = true;
+}
+
+void Server::UciServer::queue_search(const std::shared_ptr<Session>& session, const std::vector<std::string>& go_command) {
+    {
+        std::lock_guard<std::mutex> lock(session->mutex);
+        if (session->state != SessionState::IDLE) {
+            session->write("info string a search is already running\n");
+            return;
+        }
+        const auto limits = parse_go_command(go_command, session->position.end.stm(), settings.move_overhead_ms);
+        if (!limits.has_value()) {
+            // the client is still owed a bestmove for its go
+            session->write("info string error: invalid go command\nbestmove " + Search::select_random_move(session->position.end).to_string()
+                           + "\n");
+            return;
+        }
+        session->state = SessionState::QUEUED;
+        session->limits = *limits;
+    }
+    {
+        std::lock_guard<std::mutex> lock(jobs_mutex);
+        jobs.push_back(session);
+    }
+    jobs_cv.notify_one();
+}
+
+void Server::UciServer::stop_search(Session& session) {
+    std::unique_lock<std::mutex> lock(session.mutex);
+    if (session.state == SessionState::QUEUED) {
+        bool dequeued = false;
+        {
+            std::lock_guard<std::mutex> jobs_lock(jobs_mutex);
+            const auto job = std::find_if(jobs.begin(), jobs.end(), [&](const std::shared_ptr<Session>& s) { return s.get() == &session; });
+            if (job != jobs.end()) {
+                jobs.erase(job);
+                dequeued = true;
+            }
+        }
+        if (dequeued) {
+            // nothing has been searched, but UCI still wants a bestmove, and waiting for a worker to free up could take arbitrarily long
+            const auto move = Search::select_random_move(session.position.end);
+            session.state = SessionState::IDLE;
+            session.cv.notify_all();
+            lock.unlock();
+            session.write("bestmove " + move.to_string() + "\n");
+            return;
+        }
+        // a worker has taken the search from the queue, and marks it as searching as soon as it has the session's lock
+        session.cv.wait(lock, [&] { return session.state != SessionState::QUEUED; });
+    }
+    // a search that hasn't reached the point of clearing the stop flag yet would miss a single stop, so keep stopping it until it's
+    // finished
+    while (session.state == SessionState::SEARCHING) {
+        session.running_on->EndSearch();
+        lock.unlock();
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        lock.lock();
+    }
+}
+
+void Server::UciServer::run_worker(SearchHandler& handler) {
+    while (true) {
+        std::shared_ptr<Session> session;
+        {
+            std::unique_lock<std::mutex> lock(jobs_mutex);
+            jobs_cv.wait(lock, [this] { return !jobs.empty() || workers_stopping; });
+            if (jobs.empty()) {
+                return;
+            }
+            session = jobs.front();
+            jobs.pop_front();
+        }
+
+        PositionCommand position;
+        TimeControlInfo limits;
+        {
+            std::lock_guard<std::mutex> lock(session->mutex);
+            if (session->closed) {
+                session->state = SessionState::IDLE;
+                session->cv.notify_all();
+                continue;
+            }
+            session->state = SessionState::SEARCHING;
+            session->running_on = &handler;
+            position = session->position;
+            limits = session->limits;
+        }
+        session->cv.notify_all();
+
+        // one session's failure mustn't take the others down with it, so it only ends this search
+        try {
+            set_position(position, handler);
+            handler.set_info_callback([&session](const std::string& line) { session->write(line + "\n"); });
+            auto [move, score] = handler.search_sync(limits);
+            handler.set_info_callback(nullptr);
+            if (move.is_null_move()) {
+                move = Search::select_random_move(handler.get_pos());
+            }
+            session->write("bestmove " + move.to_string() + "\n");
+        } catch (const std::exception& e) {
+            handler.set_info_callback(nullptr);
+            session->write(std::string("info string error: ") + e.what() + "\nbestmove " + Search::select_random_move(position.end).to_string()
+                           + "\n");
+        }
+
+        std::lock_guard<std::mutex> lock(session->mutex);
+        session->state = SessionState::IDLE;
+        session->running_on = nullptr;
+        session->cv.notify_all();
+    }
+}
+
+int Server::run_server(const Settings& settings) {
+    UciServer server(settings);
+    if (!server.start()) {
+        printf("could not listen on %s\n", settings.socket_path.c_str());
+        return 1;
+    }
+    printf("listening on %s with %d workers and a %lu MB table\n", settings.socket_path.c_str(), std::max(settings.workers, 1),
+           settings.hash_mb);
+    fflush(stdout);
+    server.wait();
+    return 0;
+}
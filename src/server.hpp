@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "search.hpp"
+
+namespace Server {
+    struct Settings {
+        std::string socket_path;
+        // searches run at most this many at once, however many sessions are connected
+        int workers = 1;
+        // the size of the one table every session shares
+        size_t hash_mb = 64;
+        uint32_t move_overhead_ms = 10;
+    };
+
+    struct Session;
+
+    /**
+     * @brief A UCI server on a Unix domain socket, with one UCI session per connection.  Sessions are only their position and state;
+     * their searches are queued and run by a fixed pool of searchers that all share one transposition table, so memory is bounded by
+     * the number of workers rather than the number of connections
+     */
+    class UciServer {
+        private:
+            Settings settings;
+            TranspositionTable table;
+            std::vector<std::unique_ptr<SearchHandler>> handlers;
+            std::vector<std::thread> workers;
+            std::thread acceptor;
+            int listen_fd = -1;
+            std::atomic<bool> stopping = false;
+            // two threads may both wait for the server, but only one of them can join it
+            std::mutex join_mutex;
+
+            std::deque<std::shared_ptr<Session>> jobs;
+            std::mutex jobs_mutex;
+            std::condition_variable jobs_cv;
+            bool workers_stopping = false;
+
+            std::vector<std::shared_ptr<Session>> sessions;
+            std::mutex sessions_mutex;
+
+            void accept_connections();
+            void close_finished_sessions(bool all);
+            void run_session(std::shared_ptr<Session> session);
+            void run_worker(SearchHandler& handler);
+            void queue_search(const std::shared_ptr<Session>& session, const std::vector<std::string>& go_command);
+            void stop_search(Session& session);
+
+        public:
+            explicit UciServer(const Settings& settings);
+            ~UciServer() { this->stop(); };
+
+            bool start();
+            void stop();
+            void wait();
+    };
+
+    int run_server(const Settings& settings);
+} // namespace Server
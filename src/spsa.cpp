@@ -0,0 +1,218 @@
+#include "spsa.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "match.hpp"
+#include "uci_engine.hpp"
+
+// the standard SPSA gain sequence exponents, with the stability constant A as a fraction of the total iterations, matching OpenBench
+constexpr double spsa_alpha = 0.602;
+constexpr double spsa_gamma = 0.101;
+constexpr double spsa_a_ratio = 0.1;
+
+constexpr int spsa_random_opening_plies = 8;
+
+std::string Spsa::Parameter::uci_value(double v) const { return is_float ? std::to_string(v) : std::to_string(std::lround(v)); }
+
+/**
+ * @brief Parses a line of the form "name, int, value, min, max, step, learning rate", or "float" in place of "int"
+ */
+std::optional<Spsa::Parameter> Spsa::parse_parameter(const std::string& line) {
+    std::vector<std::string> fields;
+    std::istringstream stream(line);
+    for (std::string field; std::getline(stream, field, ',');) {
+        const auto first = field.find_first_not_of(' ');
+        fields.push_back(first == std::string::npos ? "" : field.substr(first));
+    }
+    if (fields.size() != 7 || (fields[1] != "int" && fields[1] != "float")) {
+        return std::nullopt;
+    }
+    try {
+        return Parameter{fields[0],
+                         fields[1] == "float",
+                         std::stod(fields[2]),
+                         std::stod(fields[3]),
+                         std::stod(fields[4]),
+                         std::stod(fields[5]),
+                         std::stod(fields[6])};
+    } catch (const std::exception&) {
+        return std::nullopt;
+    }
+}
+
+/**
+ * @brief The distance each parameter is moved either side of its current value, shrinking to the parameter's step by the final
+ * iteration
+ */
+double Spsa::perturbation_size(const Parameter& param, int iteration, int iterations) {
+    const auto c = param.step * std::pow(iterations, spsa_gamma);
+    return c / std::pow(iteration + 1, spsa_gamma);
+}
+
+/**
+ * @brief The scale applied to the game result when updating a parameter, shrinking to the parameter's learning rate by the final
+ * iteration
+ */
+double Spsa::learning_rate(const Parameter& param, int iteration, int iterations) {
+    const auto stability = spsa_a_ratio * iterations;
+    const auto a = param.learning_rate * param.step * param.step * std::pow(stability + iterations, spsa_alpha);
+    const auto a_k = a / std::pow(stability + iteration + 1, spsa_alpha);
+    const auto c_k = perturbation_size(param, iteration, iterations);
+    return a_k / (c_k * c_k);
+}
+
+struct SpsaState {
+    std::vector<Spsa::Parameter> params;
+    std::vector<Match::Opening> book;
+    std::mutex mutex;
+    std::atomic<int> next_iteration = 0;
+    int completed_iterations = 0;
+};
+
+std::vector<Spsa::Parameter> read_engine_parameters(const std::string& engine_path) {
+    std::vector<Spsa::Parameter> params;
+    UciEngine engine(engine_path);
+    engine.send("uci");
+    // an IS_TUNE build prints its parameters as it starts, before it reads any input
+    for (auto line = engine.read_line(10000); line.has_value() && *line != "uciok"; line = engine.read_line(10000)) {
+        const auto param = Spsa::parse_parameter(*line);
+        if (param.has_value()) {
+            params.push_back(*param);
+        }
+    }
+    return params;
+}
+
+void load_checkpoint(const std::string& path, SpsaState& state) {
+    std::ifstream file(path);
+    std::string name;
+    double value;
+    file >> name >> state.completed_iterations;
+    while (file >> name >> value) {
+        for (auto& param : state.params) {
+            if (param.name == name) {
+                param.value = value;
+            }
+        }
+    }
+    state.next_iteration = state.completed_iterations;
+    printf("resuming from iteration %d of %s\n", state.completed_iterations, path.c_str());
+}
+
+void write_checkpoint(const std::string& path, const SpsaState& state) {
+    // written to a temporary file first so that stopping mid-write can't lose the previous checkpoint
+    const auto temporary_path = path + ".tmp";
+    {
+        std::ofstream file(temporary_path);
+        file << "iteration " << state.completed_iterations << "\n";
+        for (const auto& param : state.params) {
+            file << param.name << " " << param.value << "\n";
+        }
+    }
+    std::filesystem::rename(temporary_path, path);
+}
+
+void print_parameters(const SpsaState& state) {
+    printf("iteration %d\n", state.completed_iterations);
+    for (const auto& param : state.params) {
+        printf("    %s = %s (%g)\n", param.name.c_str(), param.uci_value(param.value).c_str(), param.value);
+    }
+    fflush(stdout);
+}
+
+double points_for(Match::GameResult result, bool is_white) {
+    if (result == Match::GameResult::DRAW) {
+        return 0.5;
+    }
+    return ((result == Match::GameResult::WHITE_WIN) == is_white) ? 1.0 : 0.0;
+}
+
+/**
+ * @brief Runs iterations until the budget is spent.  Each iteration perturbs every parameter in a random direction, plays a pair of
+ * games between the two perturbed engines with colours reversed, and steps each parameter towards whichever side scored better
+ */
+void run_spsa_worker(SpsaState& state, const std::string& engine_path, const Spsa::Settings& settings, uint64_t seed) {
+    UciEngine plus(engine_path), minus(engine_path);
+    for (auto engine : {&plus, &minus}) {
+        engine->send("uci");
+        engine->wait_for("uciok", 10000);
+    }
+    std::mt19937_64 rng(seed);
+    std::vector<double> deltas(state.params.size());
+
+    for (int iteration; (iteration = state.next_iteration++) < settings.iterations;) {
+        {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            for (size_t i = 0; i < state.params.size(); i++) {
+                const auto& param = state.params[i];
+                deltas[i] = (rng() & 1) ? 1.0 : -1.0;
+                const auto c_k = perturbation_size(param, iteration, settings.iterations);
+                plus.set_option(param.name, param.uci_value(std::clamp(param.value + c_k * deltas[i], param.min, param.max)));
+                minus.set_option(param.name, param.uci_value(std::clamp(param.value - c_k * deltas[i], param.min, param.max)));
+            }
+        }
+
+        const auto opening = state.book.empty() ? Match::random_opening(rng, spsa_random_opening_plies) : state.book[rng() % state.book.size()];
+        const Match::SearchLimits limits = {settings.nodes};
+        const auto first = Match::play_game(plus, minus, opening, limits);
+        const auto second = Match::play_game(minus, plus, opening, limits);
+        const auto plus_points = points_for(first, true) + points_for(second, false);
+        const auto result = plus_points - (2 - plus_points);
+
+        std::lock_guard<std::mutex> lock(state.mutex);
+        for (size_t i = 0; i < state.params.size(); i++) {
+            auto& param = state.params[i];
+            const auto c_k = perturbation_size(param, iteration, settings.iterations);
+            const auto r_k = learning_rate(param, iteration, settings.iterations);
+            param.value = std::clamp(param.value + r_k * c_k * result * deltas[i], param.min, param.max);
+        }
+        state.completed_iterations += 1;
+        if (state.completed_iterations % settings.checkpoint_interval == 0) {
+            write_checkpoint(settings.checkpoint, state);
+            print_parameters(state);
+        }
+    }
+}
+
+/**
+ * @brief Tunes every parameter of an IS_TUNE build by SPSA, playing games between local copies of it.  Progress is checkpointed
+ * regularly, and an existing checkpoint is resumed from
+ */
+void Spsa::run_spsa(const std::string& engine_path, const Settings& settings) {
+    SpsaState state;
+    state.params = read_engine_parameters(engine_path);
+    if (state.params.empty()) {
+        printf("%s has no tunable parameters, was it built with IS_TUNE?\n", engine_path.c_str());
+        return;
+    }
+    if (!settings.book.empty()) {
+        state.book = Match::load_openings(settings.book);
+    }
+    if (std::filesystem::exists(settings.checkpoint)) {
+        load_checkpoint(settings.checkpoint, state);
+    }
+    printf("tuning %zu parameters for %d iterations on %d threads\n", state.params.size(), settings.iterations, settings.concurrency);
+    print_parameters(state);
+
+    std::random_device random_device;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < std::max(settings.concurrency, 1); i++) {
+        threads.emplace_back(run_spsa_worker, std::ref(state), std::cref(engine_path), std::cref(settings),
+                             (static_cast<uint64_t>(random_device()) << 32) | random_device());
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    write_checkpoint(settings.checkpoint, state);
+    print_parameters(state);
+}
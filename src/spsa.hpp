@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace Spsa {
+    /**
+     * @brief A tunable parameter as printed by an IS_TUNE build on startup, in the same format OpenBench takes as its SPSA input
+     */
+    struct Parameter {
+        std::string name;
+        bool is_float;
+        double value;
+        double min;
+        double max;
+        double step;
+        double learning_rate;
+
+        std::string uci_value(double v) const;
+    };
+
+    struct Settings {
+        int iterations = 10000;
+        int concurrency = 1;
+        uint64_t nodes = 5000;
+        std::string book;
+        std::string checkpoint = "spsa_checkpoint.txt";
+        int checkpoint_interval = 100;
+    };
+
+    std::optional<Parameter> parse_parameter(const std::string& line);
+    double perturbation_size(const Parameter& param, int iteration, int iterations);
+    double learning_rate(const Parameter& param, int iteration, int iterations);
+
+    void run_spsa(const std::string& engine_path, const Settings& settings);
+} // namespace Spsa
@@ -3,9 +3,11 @@
 #include <limits>
 #include <variant>
 #include <array>
+#include <utility>
 
 #include <cstdint>
 
+#include "move.hpp"
 #include "tunable.hpp"
 
 // Used for movestogo-based time control
@@ -16,8 +18,10 @@ struct VariableTimeTC;
 struct DepthTC;
 // Used for infinite time control
 struct InfiniteTC {};
+// Used for node-based time control
+struct NodeTC;
 
-using TimeControlInfo = std::variant<FixedTimeTC, VariableTimeTC, DepthTC, InfiniteTC>;
+using TimeControlInfo = std::variant<FixedTimeTC, VariableTimeTC, DepthTC, InfiniteTC, NodeTC>;
 
 struct FixedTimeTC {
     uint32_t search_time;
@@ -33,6 +37,13 @@ struct DepthTC {
     uint16_t depth;
 };
 
+struct NodeTC {
+    // no new iteration is started once this many nodes have been searched
+    uint64_t soft_nodes;
+    // the search is stopped as soon as this many nodes have been searched
+    uint64_t hard_nodes;
+};
+
 namespace TimeManagement {
     /**
      * @brief Determines if this std::variant is an instance of InfiniteTC
@@ -94,6 +105,22 @@ namespace TimeManagement {
         }, tc);
     }
 
+    /**
+     * @brief Gets the node limit of the search
+     * 
+     * @param tc 
+     * @return std::pair<uint64_t, uint64_t> The soft and hard node limits if this is a NodeTC object, otherwise the maximum uint64_t value
+     */
+    inline std::pair<uint64_t, uint64_t> get_node_limits(const TimeControlInfo& tc) {
+        return std::visit([](const auto& tc) {
+            if constexpr (std::is_same_v<std::decay_t<decltype(tc)>, NodeTC>) {
+                return std::make_pair(tc.soft_nodes, tc.hard_nodes);
+            } else {
+                return std::make_pair(std::numeric_limits<uint64_t>::max(), std::numeric_limits<uint64_t>::max());
+            }
+        }, tc);
+    }
+
     TUNABLE_SPECIFIER auto hard_limit_time_divisor = TUNABLE_INT("hard_limit_time_divisor", 13, 1, 20);
     TUNABLE_SPECIFIER auto hard_limit_inc_divisor = TUNABLE_INT("hard_limit_inc_divisor", 1, 1, 5);
     /**
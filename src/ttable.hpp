@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <optional>
 #include <vector>
 
@@ -135,6 +136,20 @@ class TranspositionTable {
             __builtin_prefetch(&table[tt_index(key)]);
         }
 
+        /**
+         * @brief How full the table is in permille, as UCI reports it, estimated from the first thousand entries
+         */
+        int hashfull() const {
+            const size_t clusters = std::min(table.size(), (size_t) (1000 / TT_CLUSTER_SIZE));
+            int used = 0;
+            for (size_t i = 0; i < clusters; i++) {
+                for (const auto& entry : table[i].entries) {
+                    used += static_cast<int>(entry.bound_type() != BoundTypes::NONE);
+                }
+            }
+            return used * 1000 / std::max(clusters * TT_CLUSTER_SIZE, (size_t) 1);
+        }
+
         void age() {
             current_age = (current_age + 1) % AGE_MOD;
         }
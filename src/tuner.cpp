@@ -0,0 +1,520 @@
+#include "tuner.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <sstream>
+#include <thread>
+
+#include "evaluation.hpp"
+#include "magic_numbers/eval_terms.hpp"
+#include "uci.hpp"
+
+/**
+ * @brief Reads the number a result field starts with, or nothing if there isn't one or it isn't a score between 0 and 1
+ */
+std::optional<double> parse_result_field(const std::string& line, size_t start) {
+    start = line.find_first_not_of(' ', start);
+    if (start == std::string::npos) {
+        return std::nullopt;
+    }
+    double result;
+    const auto [end, error] = std::from_chars(line.data() + start, line.data() + line.size(), result);
+    if (error != std::errc() || result < 0 || result > 1) {
+        return std::nullopt;
+    }
+    return result;
+}
+
+std::optional<double> Tuner::parse_result(const std::string& line) {
+    // results are written as "[1.0]", as a quoted PGN result or as the last "|"-separated field
+    const auto bracket = line.find('[');
+    if (bracket != std::string::npos) {
+        return parse_result_field(line, bracket + 1);
+    } else if (line.find("\"1-0\"") != std::string::npos) {
+        return 1.0;
+    } else if (line.find("\"0-1\"") != std::string::npos) {
+        return 0.0;
+    } else if (line.find("\"1/2-1/2\"") != std::string::npos) {
+        return 0.5;
+    }
+    const auto separator = line.rfind('|');
+    if (separator != std::string::npos) {
+        return parse_result_field(line, separator + 1);
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief A term, or table of terms, from eval_terms.hpp as the tuner sees it: its weights and where its counts are kept in a trace.
+ * The terms follow the piece-square tables in the parameter vector in this order
+ */
+struct TermGroup {
+    const char* name;
+    // written above the term when the tuned values are written out
+    const char* comment;
+    std::span<const int32_t> weights;
+    std::span<const int> (*counts)(const Evaluation::EvalTrace& trace);
+};
+
+using Trace = Evaluation::EvalTrace;
+
+const std::array<TermGroup, 13> TermGroups = {{
+    {"PassedPawn", "indexed by the pawn's rank relative to its own side", EvalTerms::PassedPawn,
+     [](const Trace& trace) -> std::span<const int> { return trace.passed_pawn; }},
+    {"IsolatedPawn", "", std::span(&EvalTerms::IsolatedPawn, 1), [](const Trace& trace) { return std::span(&trace.isolated_pawn, 1); }},
+    {"DoubledPawn", "", std::span(&EvalTerms::DoubledPawn, 1), [](const Trace& trace) { return std::span(&trace.doubled_pawn, 1); }},
+    {"BackwardPawn", "", std::span(&EvalTerms::BackwardPawn, 1), [](const Trace& trace) { return std::span(&trace.backward_pawn, 1); }},
+    {"PawnShield", "per friendly pawn on the king's file or an adjacent one, one or two ranks in front of the king", EvalTerms::PawnShield,
+     [](const Trace& trace) -> std::span<const int> { return trace.pawn_shield; }},
+    {"KnightMobility",
+     "indexed by the number of safe squares a piece attacks; squares holding a friendly pawn or king, or attacked by an enemy pawn, don't "
+     "count",
+     EvalTerms::KnightMobility, [](const Trace& trace) -> std::span<const int> { return trace.knight_mobility; }},
+    {"BishopMobility", "", EvalTerms::BishopMobility, [](const Trace& trace) -> std::span<const int> { return trace.bishop_mobility; }},
+    {"RookMobility", "", EvalTerms::RookMobility, [](const Trace& trace) -> std::span<const int> { return trace.rook_mobility; }},
+    {"QueenMobility", "", EvalTerms::QueenMobility, [](const Trace& trace) -> std::span<const int> { return trace.queen_mobility; }},
+    {"KingAttack", "indexed by attack units, and only applied if at least two pieces attack the king zone", EvalTerms::KingAttack,
+     [](const Trace& trace) -> std::span<const int> { return trace.king_attack; }},
+    {"PawnThreat", "a pawn attacking an enemy piece", std::span(&EvalTerms::PawnThreat, 1),
+     [](const Trace& trace) { return std::span(&trace.pawn_threat, 1); }},
+    {"MinorThreat", "a knight or bishop attacking an enemy rook or queen", std::span(&EvalTerms::MinorThreat, 1),
+     [](const Trace& trace) { return std::span(&trace.minor_threat, 1); }},
+    {"RookThreat", "a rook attacking an enemy queen", std::span(&EvalTerms::RookThreat, 1),
+     [](const Trace& trace) { return std::span(&trace.rook_threat, 1); }},
+}};
+
+void Tuner::TuningData::add_position(const Position& pos, double result) {
+    const auto tempo = (pos.stm() == Side::WHITE) ? EvalTerms::Tempo : -EvalTerms::Tempo;
+    TuningEntry entry = {
+        .fixed_mg = static_cast<int16_t>(tempo),
+        .fixed_eg = static_cast<int16_t>(tempo),
+        .mg_phase = std::min(pos.get_mg_phase(), static_cast<uint8_t>(24)),
+        .result = static_cast<uint8_t>(std::lround(result * 2)),
+        .feature_count = 0,
+    };
+    auto occupied = pos.occupancy();
+    while (!occupied.empty()) {
+        const auto sq = occupied.pop_lsb();
+        const auto piece = pos.piece_at(sq);
+        // the same indexing as PieceSquareTables::get_psqt_score
+        int idx = sq_to_int(sq);
+        if (piece.side() == Side::WHITE) {
+            idx ^= 0b00111000;
+        }
+        idx += 64 * (static_cast<int>(piece.type()) - 1);
+        features.push_back(piece.side() == Side::WHITE ? idx : idx | NegativeFeature);
+        entry.feature_count += 1;
+    }
+
+    const auto trace = Evaluation::trace_positional_terms(pos);
+    int param = PsqtParameterCount;
+    for (const auto& group : TermGroups) {
+        for (const auto count : group.counts(trace)) {
+            for (int i = 0; i < std::abs(count); i++) {
+                features.push_back(count > 0 ? param : param | NegativeFeature);
+            }
+            entry.feature_count += std::abs(count);
+            param += 1;
+        }
+    }
+    entries.push_back(entry);
+}
+
+struct FeatureCacheHeader {
+    std::array<char, 8> magic;
+    uint64_t feature_hash;
+    uint64_t entry_count;
+    uint64_t feature_count;
+};
+
+constexpr std::array<char, 8> FeatureCacheMagic = {'C', 'T', 'U', 'N', 'E', 'v', '2', '\0'};
+// bump this whenever the features extracted from a position change in a way the hash below doesn't pick up, such as a term's condition
+constexpr uint64_t FeatureVersion = 1;
+
+/**
+ * @brief Identifies the feature layout and everything that's held fixed while tuning, so that a cache written by a build with a
+ * different evaluation is rebuilt rather than read back as if it matched
+ */
+uint64_t feature_hash() {
+    uint64_t hash = 0xcbf29ce484222325;
+    const auto mix = [&hash](uint64_t value) { hash = (hash ^ value) * 0x100000001b3; };
+    mix(FeatureVersion);
+    mix(Tuner::ParameterCount);
+    for (const auto& group : TermGroups) {
+        mix(group.weights.size());
+    }
+    for (const auto weight : EvalTerms::KingAttackWeights) {
+        mix(weight);
+    }
+    mix(EvalTerms::Tempo);
+    return hash;
+}
+
+/**
+ * @brief Parses a labelled position file, one position per line.  Only the first four FEN fields are read, so EPD lines work too
+ */
+Tuner::TuningData parse_tuning_file(const std::string& path) {
+    Tuner::TuningData data;
+    std::ifstream file(path);
+    Position pos;
+    size_t skipped = 0;
+    for (std::string line; std::getline(file, line);) {
+        const auto result = Tuner::parse_result(line);
+        std::istringstream fields(line);
+        std::string fen, field;
+        for (int i = 0; i < 4 && fields >> field; i++) {
+            fen += field + " ";
+        }
+        if (!result.has_value() || !pos.set_from_fen(fen + "0 1").has_value()) {
+            skipped += 1;
+            continue;
+        }
+        data.add_position(pos, *result);
+        if (data.entries.size() % 1000000 == 0) {
+            printf("loaded %zu positions\n", data.entries.size());
+            fflush(stdout);
+        }
+    }
+    if (skipped != 0) {
+        printf("skipped %zu unparseable lines\n", skipped);
+    }
+    return data;
+}
+
+/**
+ * @brief Loads the positions in a labelled file.  Extracting features is much slower than reading them back, so they're written to
+ * a binary cache next to the file and reused until the file or the evaluation's features change
+ */
+Tuner::TuningData Tuner::load_data(const std::string& path) {
+    const auto cache_path = path + ".features";
+    if (std::filesystem::exists(cache_path) && std::filesystem::last_write_time(cache_path) >= std::filesystem::last_write_time(path)) {
+        std::ifstream cache(cache_path, std::ios::binary);
+        FeatureCacheHeader header;
+        cache.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (cache && header.magic == FeatureCacheMagic && header.feature_hash == feature_hash()) {
+            TuningData data;
+            data.entries.resize(header.entry_count);
+            data.features.resize(header.feature_count);
+            cache.read(reinterpret_cast<char*>(data.entries.data()), header.entry_count * sizeof(TuningEntry));
+            cache.read(reinterpret_cast<char*>(data.features.data()), header.feature_count * sizeof(uint16_t));
+            if (cache) {
+                printf("loaded %zu positions from %s\n", data.entries.size(), cache_path.c_str());
+                return data;
+            }
+        }
+    }
+
+    auto data = parse_tuning_file(path);
+    std::ofstream cache(cache_path, std::ios::binary);
+    const FeatureCacheHeader header = {FeatureCacheMagic, feature_hash(), data.entries.size(), data.features.size()};
+    cache.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    cache.write(reinterpret_cast<const char*>(data.entries.data()), data.entries.size() * sizeof(TuningEntry));
+    cache.write(reinterpret_cast<const char*>(data.features.data()), data.features.size() * sizeof(uint16_t));
+    return data;
+}
+
+Tuner::Parameters Tuner::initial_parameters() {
+    Parameters params;
+    for (int i = 0; i < PsqtParameterCount; i++) {
+        const auto packed = PieceSquareTables::Tables[i / 64][i % 64];
+        params[i] = {static_cast<double>(get_mg_score(packed)), static_cast<double>(get_eg_score(packed))};
+    }
+    int param = PsqtParameterCount;
+    for (const auto& group : TermGroups) {
+        for (const auto packed : group.weights) {
+            params[param++] = {static_cast<double>(get_mg_score(packed)), static_cast<double>(get_eg_score(packed))};
+        }
+    }
+    return params;
+}
+
+double Tuner::linear_eval(const TuningEntry& entry, const uint16_t* features, const Parameters& params) {
+    double mg = entry.fixed_mg, eg = entry.fixed_eg;
+    for (int i = 0; i < entry.feature_count; i++) {
+        const auto& param = params[features[i] & ~NegativeFeature];
+        const double sign = (features[i] & NegativeFeature) ? -1.0 : 1.0;
+        mg += sign * param[0];
+        eg += sign * param[1];
+    }
+    return (mg * entry.mg_phase + eg * (24 - entry.mg_phase)) / 24;
+}
+
+struct TuningChunk {
+    size_t first_entry;
+    size_t last_entry;
+    size_t first_feature;
+};
+
+std::vector<TuningChunk> split_into_chunks(const Tuner::TuningData& data, int chunk_count) {
+    std::vector<TuningChunk> chunks;
+    const auto chunk_size = (data.entries.size() + chunk_count - 1) / chunk_count;
+    size_t feature_idx = 0;
+    for (size_t first = 0; first < data.entries.size(); first += chunk_size) {
+        const auto last = std::min(first + chunk_size, data.entries.size());
+        chunks.push_back({first, last, feature_idx});
+        for (size_t i = first; i < last; i++) {
+            feature_idx += data.entries[i].feature_count;
+        }
+    }
+    return chunks;
+}
+
+double sigmoid(double k, double eval) { return 1.0 / (1.0 + std::exp(-k * eval)); }
+
+/**
+ * @brief Returns the summed squared error of a chunk, adding the gradient of each parameter to gradient if one is given
+ */
+double process_chunk(const Tuner::TuningData& data, const TuningChunk& chunk, const Tuner::Parameters& params, double k,
+                     Tuner::Parameters* gradient) {
+    double error = 0;
+    const uint16_t* features = data.features.data() + chunk.first_feature;
+    for (size_t i = chunk.first_entry; i < chunk.last_entry; i++) {
+        const auto& entry = data.entries[i];
+        const auto predicted = sigmoid(k, Tuner::linear_eval(entry, features, params));
+        const auto difference = predicted - entry.result / 2.0;
+        error += difference * difference;
+        if (gradient != nullptr) {
+            const auto eval_gradient = 2 * difference * predicted * (1 - predicted) * k;
+            const auto mg_gradient = eval_gradient * entry.mg_phase / 24;
+            const auto eg_gradient = eval_gradient * (24 - entry.mg_phase) / 24;
+            for (int j = 0; j < entry.feature_count; j++) {
+                auto& param_gradient = (*gradient)[features[j] & ~Tuner::NegativeFeature];
+                const double sign = (features[j] & Tuner::NegativeFeature) ? -1.0 : 1.0;
+                param_gradient[0] += sign * mg_gradient;
+                param_gradient[1] += sign * eg_gradient;
+            }
+        }
+        features += entry.feature_count;
+    }
+    return error;
+}
+
+/**
+ * @brief Computes the mean squared error over every position with one thread per chunk.  Each thread accumulates its own gradient,
+ * and these are summed afterwards so the threads never write to shared memory
+ */
+double compute_error(const Tuner::TuningData& data, const std::vector<TuningChunk>& chunks, const Tuner::Parameters& params, double k,
+                     Tuner::Parameters* gradient) {
+    std::vector<double> errors(chunks.size());
+    std::vector<Tuner::Parameters> gradients(gradient != nullptr ? chunks.size() : 0, Tuner::Parameters{});
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < chunks.size(); i++) {
+        threads.emplace_back([&, i]() { errors[i] = process_chunk(data, chunks[i], params, k, gradient != nullptr ? &gradients[i] : nullptr); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    double error = 0;
+    for (const auto chunk_error : errors) {
+        error += chunk_error;
+    }
+    const auto scale = 1.0 / data.entries.size();
+    if (gradient != nullptr) {
+        *gradient = {};
+        for (const auto& chunk_gradient : gradients) {
+            for (int i = 0; i < Tuner::ParameterCount; i++) {
+                (*gradient)[i][0] += chunk_gradient[i][0] * scale;
+                (*gradient)[i][1] += chunk_gradient[i][1] * scale;
+            }
+        }
+    }
+    return error * scale;
+}
+
+/**
+ * @brief Finds the sigmoid scaling that best fits the starting evaluation to the results, so the tuner changes the shape of the
+ * evaluation rather than its scale
+ */
+double find_optimal_k(const Tuner::TuningData& data, const std::vector<TuningChunk>& chunks, const Tuner::Parameters& params) {
+    double low = 0, high = 0.05;
+    for (int i = 0; i < 40; i++) {
+        const auto third = (high - low) / 3;
+        if (compute_error(data, chunks, params, low + third, nullptr) < compute_error(data, chunks, params, high - third, nullptr)) {
+            high -= third;
+        } else {
+            low += third;
+        }
+    }
+    return (low + high) / 2;
+}
+
+void Tuner::write_piece_square_tables(const std::string& path, const Parameters& params) {
+    constexpr std::array<const char*, 6> table_names = {"PawnTable", "KnightTable", "BishopTable", "RookTable", "QueenTable", "KingTable"};
+    std::ofstream out(path);
+    out << "#pragma once\n\n#include <array>\n\n#include \"../utils.hpp\"\n#include \"../pieces.hpp\"\n\n";
+    out << "constexpr int32_t S(int32_t mg, int32_t eg) { return static_cast<int32_t>(static_cast<uint32_t>(eg) << 16) + mg; };\n\n";
+    out << "namespace PieceSquareTables {\n    // clang-format off\n\n";
+    char buf[32];
+    for (int table = 0; table < 6; table++) {
+        out << "    constexpr std::array<int32_t, 64> " << table_names[table] << " = {\n";
+        for (int row = 0; row < 8; row++) {
+            out << "        ";
+            for (int col = 0; col < 8; col++) {
+                const auto& param = params[table * 64 + row * 8 + col];
+                snprintf(buf, sizeof(buf), "S(%4ld,%4ld),", std::lround(param[0]), std::lround(param[1]));
+                out << buf << (col == 7 ? "\n" : " ");
+            }
+        }
+        out << "    };\n\n";
+    }
+    out << "    constexpr std::array<std::array<int32_t, 64>, 6> Tables = {\n        {\n";
+    for (int table = 0; table < 6; table++) {
+        out << "            " << table_names[table] << (table == 5 ? "\n" : ",\n");
+    }
+    out << "        }\n    };\n\n";
+    out << "    constexpr inline int32_t get_psqt_score(const Piece p, Square sq) {\n";
+    out << "        int pos = sq_to_int(sq);\n        if (p.side() == Side::WHITE) {\n            pos ^= 0b00111000;\n        }\n";
+    out << "        return Tables[static_cast<int>(p.type()) - 1][pos];\n    }\n\n";
+    out << "    // clang-format on\n};\n";
+}
+
+std::string format_score(const std::array<double, 2>& param) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "S(%3ld,%3ld)", std::lround(param[0]), std::lround(param[1]));
+    return buf;
+}
+
+/**
+ * @brief Writes eval_terms.hpp with the tuned weights.  The king attack weights and the tempo bonus aren't tuned, so they're written
+ * out as they are
+ */
+void Tuner::write_eval_terms(const std::string& path, const Parameters& params) {
+    std::ofstream out(path);
+    out << "#pragma once\n\n#include <array>\n\n#include \"piece_square_tables.hpp\"\n\n";
+    out << "namespace EvalTerms {\n    // clang-format off\n\n";
+    int param = PsqtParameterCount;
+    for (const auto& group : TermGroups) {
+        if (std::string(group.name) == "KingAttack") {
+            out << "    // attack units per square of the enemy king zone (the king and its neighbouring squares) attacked, indexed by piece type\n";
+            out << "    constexpr std::array<int, " << EvalTerms::KingAttackWeights.size() << "> KingAttackWeights = {";
+            for (size_t i = 0; i < EvalTerms::KingAttackWeights.size(); i++) {
+                out << (i == 0 ? " " : ", ") << EvalTerms::KingAttackWeights[i];
+            }
+            out << " };\n    constexpr int MaxKingAttackUnits = " << EvalTerms::MaxKingAttackUnits << ";\n\n";
+        }
+        if (group.comment[0] != '\0') {
+            out << "    // " << group.comment << "\n";
+        }
+        if (group.weights.size() == 1) {
+            out << "    constexpr int32_t " << group.name << " = " << format_score(params[param++]) << ";\n\n";
+            continue;
+        }
+        out << "    constexpr std::array<int32_t, " << group.weights.size() << "> " << group.name << " = {\n";
+        for (size_t i = 0; i < group.weights.size(); i++) {
+            out << (i % 10 == 0 ? "        " : " ") << format_score(params[param++]) << ",";
+            if (i % 10 == 9 || i + 1 == group.weights.size()) {
+                out << "\n";
+            }
+        }
+        out << "    };\n\n";
+    }
+    out << "    // added for the side to move after tapering\n    constexpr int Tempo = " << EvalTerms::Tempo << ";\n\n";
+    out << "    // clang-format on\n} // namespace EvalTerms\n";
+}
+
+/**
+ * @brief Parses the options following the data file: the epochs, threads and the two output paths in that order, then --terms-only and
+ * --regularization in any position.  Returns nothing if an option is unknown or a value doesn't parse
+ */
+std::optional<Tuner::Settings> Tuner::parse_args(const std::vector<std::string>& args) {
+    Settings settings;
+    settings.threads = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+    std::vector<std::string> positional;
+    for (size_t i = 0; i < args.size(); i++) {
+        if (args[i] == "--terms-only") {
+            settings.tune_psqt = false;
+        } else if (args[i] == "--regularization" && i + 1 < args.size()) {
+            const auto regularization = parse_number<double>(args[++i]);
+            if (!regularization.has_value() || *regularization < 0) {
+                return std::nullopt;
+            }
+            settings.regularization = *regularization;
+        } else if (args[i].starts_with("-") || positional.size() == 4) {
+            return std::nullopt;
+        } else {
+            positional.push_back(args[i]);
+        }
+    }
+
+    if (positional.size() > 0) {
+        const auto epochs = parse_number<int>(positional[0]);
+        if (!epochs.has_value() || *epochs < 1) {
+            return std::nullopt;
+        }
+        settings.epochs = *epochs;
+    }
+    if (positional.size() > 1) {
+        const auto threads = parse_number<int>(positional[1]);
+        if (!threads.has_value() || *threads < 1) {
+            return std::nullopt;
+        }
+        settings.threads = *threads;
+    }
+    if (positional.size() > 2) {
+        settings.psqt_path = positional[2];
+    }
+    if (positional.size() > 3) {
+        settings.terms_path = positional[3];
+    }
+    return settings;
+}
+
+/**
+ * @brief Tunes the piece-square tables and the evaluation terms against a file of labelled positions with Adam, starting from the
+ * current values.  Every epoch uses the full dataset, and the files are rewritten every 100 epochs so a long run can be stopped at
+ * any time.  Adam moves a weight about as far whether it appears in every position or a handful, so rare weights such as the top
+ * king attack entries overfit unless the regularization holds them near where they started
+ */
+void Tuner::run_tune(const std::string& data_path, const Settings& settings) {    constexpr double learning_rate = 1.0;
+    constexpr double beta1 = 0.9;
+    constexpr double beta2 = 0.999;
+    constexpr double epsilon = 1e-8;
+
+    const auto data = load_data(data_path);
+    if (data.entries.empty()) {
+        printf("no positions to tune on\n");
+        return;
+    }
+    const auto chunks = split_into_chunks(data, std::max(settings.threads, 1));
+    const auto initial = initial_parameters();
+    auto params = initial;
+    const auto k = find_optimal_k(data, chunks, params);
+    printf("tuning %zu positions on %zu threads, k = %.6f, initial error %.6f\n", data.entries.size(), chunks.size(), k,
+           compute_error(data, chunks, params, k, nullptr));
+    fflush(stdout);
+
+    const auto start_time = std::chrono::steady_clock::now();
+    Parameters momentum = {}, velocity = {}, gradient = {};
+    const int first_tuned = settings.tune_psqt ? 0 : PsqtParameterCount;
+    for (int epoch = 1; epoch <= settings.epochs; epoch++) {
+        const auto error = compute_error(data, chunks, params, k, &gradient);
+        const auto momentum_correction = 1 - std::pow(beta1, epoch);
+        const auto velocity_correction = 1 - std::pow(beta2, epoch);
+        for (int i = first_tuned; i < ParameterCount; i++) {
+            for (int j = 0; j < 2; j++) {
+                gradient[i][j] += settings.regularization * (params[i][j] - initial[i][j]);
+                momentum[i][j] = beta1 * momentum[i][j] + (1 - beta1) * gradient[i][j];
+                velocity[i][j] = beta2 * velocity[i][j] + (1 - beta2) * gradient[i][j] * gradient[i][j];
+                params[i][j] -= learning_rate * (momentum[i][j] / momentum_correction) / (std::sqrt(velocity[i][j] / velocity_correction) + epsilon);
+            }
+        }
+        if (epoch % 10 == 0 || epoch == settings.epochs) {
+            const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+            printf("epoch %d error %.6f (%.1fs)\n", epoch, error, elapsed);
+            fflush(stdout);
+        }
+        if (epoch % 100 == 0 || epoch == settings.epochs) {
+            if (settings.tune_psqt) {
+                write_piece_square_tables(settings.psqt_path, params);
+            }
+            write_eval_terms(settings.terms_path, params);
+        }
+    }
+}
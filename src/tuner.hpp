@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "chessboard.hpp"
+#include "magic_numbers/eval_terms.hpp"
+
+namespace Tuner {
+    constexpr int PsqtParameterCount = 6 * 64;
+    // every weight in eval_terms.hpp that the evaluation applies linearly, in the order the file lists them
+    constexpr int TermParameterCount = EvalTerms::PassedPawn.size() + 3 + EvalTerms::PawnShield.size() + EvalTerms::KnightMobility.size()
+                                       + EvalTerms::BishopMobility.size() + EvalTerms::RookMobility.size() + EvalTerms::QueenMobility.size()
+                                       + EvalTerms::KingAttack.size() + 3;
+    // one mg/eg pair per square of each piece-square table, followed by one per term weight
+    constexpr int ParameterCount = PsqtParameterCount + TermParameterCount;
+
+    using Parameters = std::array<std::array<double, 2>, ParameterCount>;
+
+    /**
+     * @brief A labelled position reduced to what the linear evaluation needs.  Only the tempo bonus is held fixed during tuning, and
+     * it's stored in fixed_mg and fixed_eg.  The king attack weights aren't tuned either, as they choose which KingAttack entry
+     * applies rather than scaling one
+     */
+    struct TuningEntry {
+        int16_t fixed_mg;
+        int16_t fixed_eg;
+        uint8_t mg_phase;
+        uint8_t result; // 0, 1 or 2 for a black win, a draw or a white win
+        uint16_t feature_count;
+    };
+    static_assert(sizeof(TuningEntry) == 8);
+
+    /**
+     * @brief Entries and their features, stored back to back.  Each feature is the index of a parameter, with the top bit set when it
+     * counts against white rather than for it, and a term that applies several times is repeated.  A position takes up 8 bytes plus 2
+     * per piece and per term
+     */
+    struct TuningData {
+        std::vector<TuningEntry> entries;
+        std::vector<uint16_t> features;
+
+        void add_position(const Position& pos, double result);
+    };
+
+    constexpr uint16_t NegativeFeature = 0x8000;
+
+    std::optional<double> parse_result(const std::string& line);
+    TuningData load_data(const std::string& path);
+    Parameters initial_parameters();
+    double linear_eval(const TuningEntry& entry, const uint16_t* features, const Parameters& params);
+    void write_piece_square_tables(const std::string& path, const Parameters& params);
+    void write_eval_terms(const std::string& path, const Parameters& params);
+
+    struct Settings {
+        int epochs = 1000;
+        int threads = 1;
+        std::string psqt_path = "piece_square_tables.hpp";
+        std::string terms_path = "eval_terms.hpp";
+        // with this unset the piece-square tables stay as they are, and only the terms are tuned
+        bool tune_psqt = true;
+        // the strength of the pull back towards the starting values, which keeps weights the data says little about from wandering off
+        double regularization = 0;
+    };
+
+    std::optional<Settings> parse_args(const std::vector<std::string>& args);
+    void run_tune(const std::string& data_path, const Settings& settings);
+} // namespace Tuner
@@ -0,0 +1,153 @@
+#include "uci.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <limits>
+
+#include "move_generator.hpp"
+
+std::vector<std::string> split_on_whitespace(const std::string& data) {
+    std::vector<std::string> to_return;
+    std::string s;
+    for (auto& c : data) {
+        if (!std::isspace(c)) {
+            s.push_back(c);
+        } else if (s.length() != 0) {
+            to_return.push_back(s);
+            s = std::string();
+        }
+    }
+    if (s.length() != 0) {
+        to_return.push_back(s);
+    }
+    return to_return;
+}
+
+/**
+ * @brief Parses a UCI position command, checking every move against the legal moves, so that a bad command can be rejected before
+ * any position is changed
+ */
+std::optional<PositionCommand> parse_position_command(const std::string& line) {
+    auto parsed_line = split_on_whitespace(line);
+    if (parsed_line.size() < 2) {
+        return std::nullopt;
+    }
+    size_t fen_idx;
+    if (parsed_line[1] == "fen") {
+        fen_idx = line.find("fen") + 3;
+        while (fen_idx < line.size() && std::isspace(line[fen_idx])) {
+            fen_idx += 1;
+        }
+    } else if (parsed_line[1] == "startpos") {
+        fen_idx = line.find("startpos");
+    } else {
+        return std::nullopt; // not a valid position
+    }
+    auto sub_line = line.substr(fen_idx);
+    PositionCommand command;
+    auto idx = command.start.set_from_fen(sub_line);
+    // the search assumes exactly one king a side
+    if (!idx.has_value() || command.start.kings(Side::WHITE).popcnt() != 1 || command.start.kings(Side::BLACK).popcnt() != 1) {
+        return std::nullopt;
+    }
+    const auto rest = split_on_whitespace(sub_line.substr(idx.value()));
+    // the rest is either empty or the moves made from the FEN
+    if (!rest.empty() && rest[0] != "moves") {
+        return std::nullopt;
+    }
+    command.end = command.start;
+    for (size_t i = 1; i < rest.size(); i++) {
+        // making anything but a legal move would corrupt the position
+        const auto legal_moves = MoveGenerator::generate_legal_moves<MoveGenType::ALL_LEGAL>(command.end, command.end.stm());
+        const auto legal = std::find_if(legal_moves.begin(), legal_moves.end(), [&](const ScoredMove& m) { return m.move.to_string() == rest[i]; });
+        if (legal == legal_moves.end()) {
+            return std::nullopt;
+        }
+        command.moves.push_back(legal->move);
+        command.end = Position(command.end, legal->move);
+    }
+    return command;
+}
+
+void set_position(const PositionCommand& command, SearchHandler& s) {
+    // reuses the history's storage, as constructing a new one allocates room for the longest possible game
+    auto& history = s.get_history();
+    history.clear();
+    history.push_board(command.start);
+    Position c = command.start;
+    for (const auto move : command.moves) {
+        c = c.make_move(move, history);
+    }
+}
+
+bool process_position_command(const std::string& line, SearchHandler& s) {
+    const auto command = parse_position_command(line);
+    if (command.has_value()) {
+        set_position(*command, s);
+    }
+    return command.has_value();
+}
+
+/**
+ * @brief The time control of a UCI go command, from the perspective of the side to move.  The first of infinite, depth and nodes
+ * found wins, then movetime, and otherwise the clocks are used
+ *
+ * @return std::optional<TimeControlInfo> Nothing if a value in the command isn't a number
+ */
+std::optional<TimeControlInfo> parse_go_command(const std::vector<std::string>& line, Side stm, uint32_t move_overhead) {
+    // clocks can go negative once a side has flagged, so they're read signed and clamped
+    int64_t wtime = 0, btime = 0, winc = 0, binc = 0, movetime = 0;
+    int64_t movestogo = 1;
+    if (line.size() == 0) {
+        return InfiniteTC{};
+    }
+    for (size_t i = 0; i < line.size(); i++) {
+        auto& this_elem = line[i];
+        if (this_elem == "infinite") {
+            return InfiniteTC{};
+        } else if (i != (line.size() - 1)) {
+            if (this_elem == "depth") {
+                const auto depth = parse_number<int>(line[i + 1]);
+                if (!depth.has_value()) {
+                    return std::nullopt;
+                }
+                return DepthTC{static_cast<uint16_t>(std::clamp(*depth, 1, MAX_PLY - PLY_OFFSET))};
+            } else if (this_elem == "nodes") {
+                const auto nodes = parse_number<uint64_t>(line[i + 1]);
+                if (!nodes.has_value()) {
+                    return std::nullopt;
+                }
+                return NodeTC{*nodes, *nodes};
+            }
+            int64_t* value = (this_elem == "wtime")       ? &wtime
+                             : (this_elem == "btime")     ? &btime
+                             : (this_elem == "winc")      ? &winc
+                             : (this_elem == "binc")      ? &binc
+                             : (this_elem == "movetime")  ? &movetime
+                             : (this_elem == "movestogo") ? &movestogo
+                                                          : nullptr;
+            if (value != nullptr) {
+                const auto parsed = parse_number<int64_t>(line[i + 1]);
+                if (!parsed.has_value()) {
+                    return std::nullopt;
+                }
+                *value = std::clamp(*parsed, (int64_t) 0, (int64_t) std::numeric_limits<uint32_t>::max());
+            }
+        }
+    }
+    if (movetime != 0) {
+        return FixedTimeTC{static_cast<uint32_t>(movetime)};
+    }
+    // auto halfmoves_so_far = (2 * s.get_pos().get_fullmove_counter()) + static_cast<int>(stm);
+    // with less time left than the overhead there's still a move to make, so the search gets as little time as it can have
+    const auto remaining_time = static_cast<uint32_t>(std::max(((stm == Side::WHITE) ? wtime : btime) - move_overhead, (int64_t) 1));
+    const auto increment = static_cast<uint32_t>(((stm == Side::WHITE) ? winc : binc) / std::max(movestogo, (int64_t) 1));
+    // next we determine how to use our allocated time using the formula
+    // 59.3 + (72830 - 2330 k)/(2644 + k (10 + k)), where k is the number of halfmoves
+    // so far.  This formula is taken from https://chess.stackexchange.com/questions/2506/what-is-the-average-length-of-a-game-of-chess.
+    // float remaining_halfmoves =
+    //    59.3 + (static_cast<float>(72830 - (2330 * halfmoves_so_far)) / static_cast<float>(2644 + (halfmoves_so_far * (10 + halfmoves_so_far))));
+
+    // s.search((remaining_time / static_cast<int>(remaining_halfmoves)) + increment, depth);
+    return VariableTimeTC{TimeManagement::calculate_hard_limit(remaining_time, increment), remaining_time, increment};
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <charconv>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "search.hpp"
+#include "time_management.hpp"
+
+std::vector<std::string> split_on_whitespace(const std::string& data);
+/**
+ * @brief A position command's starting position and the moves made from it, along with the position they lead to
+ */
+struct PositionCommand {
+    Position start;
+    std::vector<Move> moves;
+    Position end;
+};
+
+std::optional<PositionCommand> parse_position_command(const std::string& line);
+void set_position(const PositionCommand& command, SearchHandler& s);
+bool process_position_command(const std::string& line, SearchHandler& s);
+std::optional<TimeControlInfo> parse_go_command(const std::vector<std::string>& line, Side stm, uint32_t move_overhead);
+
+/**
+ * @brief Parses the whole of s as a number, without the exceptions of std::stoi, as commands may come from clients that can't be trusted
+ */
+template <typename T> std::optional<T> parse_number(const std::string& s) {
+    T value;
+    const auto [end, error] = std::from_chars(s.data(), s.data() + s.size(), value);
+    if (error != std::errc() || end != s.data() + s.size()) {
+        return std::nullopt;
+    }
+    return value;
+}
@@ -0,0 +1,132 @@
+#include "uci_engine.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+UciEngine::UciEngine(const std::string& path) {
+    // every descriptor is close-on-exec, so that an engine doesn't inherit the ends of other engines' pipes and keep them open after
+    // those engines exit.  The engine's input is a socket rather than a pipe so that writes to it can use MSG_NOSIGNAL, as an engine
+    // that exits early would otherwise kill us with SIGPIPE on the next write
+    int to_child[2], from_child[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, to_child) != 0) {
+        return;
+    }
+    if (pipe2(from_child, O_CLOEXEC) != 0) {
+        close(to_child[0]);
+        close(to_child[1]);
+        return;
+    }
+    pid = fork();
+    if (pid == 0) {
+        // dup2 clears close-on-exec on the copies, so only these two survive the exec
+        dup2(to_child[0], STDIN_FILENO);
+        dup2(from_child[1], STDOUT_FILENO);
+        execl(path.c_str(), path.c_str(), static_cast<char*>(nullptr));
+        _exit(127);
+    }
+    close(to_child[0]);
+    close(from_child[1]);
+    to_engine = to_child[1];
+    from_engine = from_child[0];
+    if (pid < 0) {
+        close(to_engine);
+        close(from_engine);
+    }
+}
+
+UciEngine::~UciEngine() {
+    if (!is_running()) {
+        return;
+    }
+    send("quit");
+    close(to_engine);
+    close(from_engine);
+    // give the engine a moment to exit cleanly before killing it
+    for (int i = 0; i < 100; i++) {
+        if (waitpid(pid, nullptr, WNOHANG) == pid) {
+            return;
+        }
+        usleep(10000);
+    }
+    kill(pid, SIGKILL);
+    waitpid(pid, nullptr, 0);
+}
+
+void UciEngine::send(const std::string& command) {
+    const auto line = command + "\n";
+    size_t written = 0;
+    while (is_running() && written < line.size()) {
+        const auto result = ::send(to_engine, line.data() + written, line.size() - written, MSG_NOSIGNAL);
+        if (result <= 0) {
+            return;
+        }
+        written += result;
+    }
+}
+
+/**
+ * @brief Reads the next line the engine writes
+ *
+ * @param timeout_ms How long to wait for a full line, or -1 to wait forever
+ * @return std::optional<std::string> The line without its newline, or nothing if the engine timed out or exited
+ */
+std::optional<std::string> UciEngine::read_line(int timeout_ms) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (is_running()) {
+        const auto newline = buffer.find('\n');
+        if (newline != std::string::npos) {
+            auto line = buffer.substr(0, newline);
+            buffer.erase(0, newline + 1);
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            return line;
+        }
+
+        int wait_ms = -1;
+        if (timeout_ms >= 0) {
+            wait_ms = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+            if (wait_ms <= 0) {
+                return std::nullopt;
+            }
+        }
+        pollfd fd = {from_engine, POLLIN, 0};
+        if (poll(&fd, 1, wait_ms) <= 0) {
+            continue;
+        }
+        char data[4096];
+        const auto count = read(from_engine, data, sizeof(data));
+        if (count <= 0) {
+            return std::nullopt;
+        }
+        buffer.append(data, count);
+    }
+    return std::nullopt;
+}
+
+std::optional<std::string> UciEngine::wait_for(const std::string& prefix, int timeout_ms) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (true) {
+        int remaining = -1;
+        if (timeout_ms >= 0) {
+            remaining = std::max(
+                static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count()), 0);
+        }
+        auto line = read_line(remaining);
+        if (!line.has_value() || line->starts_with(prefix)) {
+            return line;
+        }
+    }
+}
+
+bool UciEngine::is_ready(int timeout_ms) {
+    send("isready");
+    return wait_for("readyok", timeout_ms).has_value();
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <optional>
+#include <string>
+
+#include <sys/types.h>
+
+/**
+ * @brief An engine running as a child process, spoken to over UCI through a socket for its input and a pipe for its output
+ */
+class UciEngine {
+    private:
+        pid_t pid = -1;
+        int to_engine = -1;
+        int from_engine = -1;
+        std::string buffer;
+
+    public:
+        UciEngine(const std::string& path);
+        ~UciEngine();
+        UciEngine(const UciEngine&) = delete;
+        UciEngine& operator=(const UciEngine&) = delete;
+
+        bool is_running() const { return pid > 0; };
+        void send(const std::string& command);
+        std::optional<std::string> read_line(int timeout_ms = -1);
+        std::optional<std::string> wait_for(const std::string& prefix, int timeout_ms = -1);
+
+        void set_option(const std::string& name, const std::string& value) { send("setoption name " + name + " value " + value); };
+        bool is_ready(int timeout_ms = 10000);
+};
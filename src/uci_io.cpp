@@ -0,0 +1,103 @@
+#include "uci_io.hpp"
+
+#include <cstdio>
+
+#include <poll.h>
+
+void UciOutput::flush_locked() {
+    if (fd == STDOUT_FILENO) {
+        // anything printed directly, such as perft results, goes out ahead of the lines written since
+        fflush(stdout);
+    }
+    if (buffer.empty()) {
+        return;
+    }
+    for (size_t written = 0; written < buffer.size();) {
+        const auto result = ::write(fd, buffer.data() + written, buffer.size() - written);
+        if (result <= 0) {
+            break;
+        }
+        written += result;
+    }
+    buffer.clear();
+    last_flush = std::chrono::steady_clock::now();
+}
+
+void UciOutput::write_line(const std::string& line) {
+    std::lock_guard<std::mutex> lock(mutex);
+    buffer += line;
+    buffer += '\n';
+    if (std::chrono::steady_clock::now() - last_flush >= flush_interval) {
+        flush_locked();
+    }
+}
+
+void UciOutput::flush() {
+    std::lock_guard<std::mutex> lock(mutex);
+    flush_locked();
+}
+
+void UciOutput::send(const std::string& line) {
+    std::lock_guard<std::mutex> lock(mutex);
+    buffer += line;
+    buffer += '\n';
+    flush_locked();
+}
+
+UciInput::UciInput(int fd, UciOutput& output, std::function<void()> on_stop) : fd(fd), output(output), on_stop(std::move(on_stop)) {
+    reader = std::thread(&UciInput::read_lines, this);
+}
+
+UciInput::~UciInput() {
+    stopping = true;
+    reader.join();
+}
+
+void UciInput::read_lines() {
+    std::string partial;
+    char data[4096];
+    while (!stopping) {
+        pollfd p = {fd, POLLIN, 0};
+        const auto ready = poll(&p, 1, uci_flush_interval_ms);
+        output.flush();
+        if (ready <= 0) {
+            continue;
+        }
+        const auto received = read(fd, data, sizeof(data));
+        if (received <= 0) {
+            break;
+        }
+        partial.append(data, received);
+        for (auto end = partial.find('\n'); end != std::string::npos; end = partial.find('\n')) {
+            auto line = partial.substr(0, end);
+            partial.erase(0, end + 1);
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            if (line == "stop" || line == "quit") {
+                // the main thread still handles the command in order, but the search stops now
+                on_stop();
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            lines.push_back(std::move(line));
+            cv.notify_one();
+        }
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!partial.empty()) {
+        lines.push_back(std::move(partial));
+    }
+    eof = true;
+    cv.notify_one();
+}
+
+std::optional<std::string> UciInput::next_line() {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [this] { return !lines.empty() || eof; });
+    if (lines.empty()) {
+        return std::nullopt;
+    }
+    auto line = std::move(lines.front());
+    lines.pop_front();
+    return line;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
+// info lines written closer together than this are sent in one write, so a burst of shallow iterations costs one syscall rather than
+// one each, while none of them waits longer than this to be sent
+constexpr int uci_flush_interval_ms = 10;
+
+/**
+ * @brief Buffered UCI output.  Lines are sent at once if nothing has been sent for the flush interval and are otherwise held until the
+ * next flush, which the input thread makes at least once per interval; replies the GUI waits on, such as bestmove, are flushed
+ * immediately
+ */
+class UciOutput {
+    private:
+        int fd;
+        std::chrono::milliseconds flush_interval;
+        std::string buffer;
+        std::chrono::steady_clock::time_point last_flush;
+        std::mutex mutex;
+
+        void flush_locked();
+
+    public:
+        UciOutput(int fd = STDOUT_FILENO, int flush_interval_ms = uci_flush_interval_ms) : fd(fd), flush_interval(flush_interval_ms) {};
+
+        void write_line(const std::string& line);
+        void flush();
+        // writes a line that the GUI is waiting for, such as bestmove or readyok
+        void send(const std::string& line);
+};
+
+inline UciOutput& uci_output() {
+    static UciOutput output;
+    return output;
+}
+
+/**
+ * @brief Reads UCI commands on a thread of its own, so that a stop or quit cancels the search as soon as it arrives rather than once
+ * the main thread has got through the commands before it.  The thread also flushes the output whenever it has waited for the flush
+ * interval without reading anything
+ */
+class UciInput {
+    private:
+        int fd;
+        UciOutput& output;
+        std::function<void()> on_stop;
+        std::thread reader;
+        std::atomic<bool> stopping = false;
+
+        std::deque<std::string> lines;
+        bool eof = false;
+        std::mutex mutex;
+        std::condition_variable cv;
+
+        void read_lines();
+
+    public:
+        UciInput(int fd, UciOutput& output, std::function<void()> on_stop);
+        ~UciInput();
+
+        // the next command, waiting for one if necessary, or nothing once the input has closed
+        std::optional<std::string> next_line();
+};
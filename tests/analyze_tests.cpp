@@ -0,0 +1,40 @@
+#include <gtest/gtest.h>
+
+#include "../src/analyze.hpp"
+
+TEST(AnalyzeTests, TestParseEpdLine) {
+    const auto epd = Analyze::parse_epd_line("2rr3k/pp3pp1/1nnqbN1p/3pN3/2pP4/2P3Q1/PPB4P/R4RK1 w - - bm Qg6; id \"WAC.001\";");
+    ASSERT_TRUE(epd.has_value());
+    ASSERT_EQ(epd->fen, "2rr3k/pp3pp1/1nnqbN1p/3pN3/2pP4/2P3Q1/PPB4P/R4RK1 w - - 0 1");
+    ASSERT_EQ(epd->id, "WAC.001");
+
+    const auto fen = Analyze::parse_epd_line("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 3 17");
+    ASSERT_TRUE(fen.has_value());
+    ASSERT_EQ(fen->fen, "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 3 17");
+    ASSERT_EQ(fen->id, "");
+
+    ASSERT_FALSE(Analyze::parse_epd_line("8/8/8/8 w").has_value());
+    ASSERT_FALSE(Analyze::parse_epd_line("").has_value());
+}
+
+TEST(AnalyzeTests, TestParseArgs) {
+    const auto settings = Analyze::parse_args({"--nodes", "5000", "--threads", "2", "--hash", "8", "--shared-tt"});
+    ASSERT_TRUE(settings.has_value());
+    ASSERT_TRUE(std::holds_alternative<NodeTC>(settings->limits));
+    ASSERT_EQ(std::get<NodeTC>(settings->limits).hard_nodes, 5000);
+    ASSERT_EQ(settings->threads, 2);
+    ASSERT_EQ(settings->hash_mb, 8);
+    ASSERT_TRUE(settings->shared_tt);
+
+    const auto depth = Analyze::parse_args({"--depth", "7"});
+    ASSERT_TRUE(depth.has_value());
+    ASSERT_EQ(std::get<DepthTC>(depth->limits).depth, 7);
+    ASSERT_FALSE(depth->shared_tt);
+
+    ASSERT_FALSE(Analyze::parse_args({"--depth", "x"}).has_value());
+    ASSERT_FALSE(Analyze::parse_args({"--depth", "0"}).has_value());
+    ASSERT_FALSE(Analyze::parse_args({"--depth"}).has_value());
+    ASSERT_FALSE(Analyze::parse_args({"--movetime", "-5"}).has_value());
+    ASSERT_FALSE(Analyze::parse_args({"--dpeth", "7"}).has_value());
+    ASSERT_FALSE(Analyze::parse_args({"extra"}).has_value());
+}
@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "../src/chessatron.h"
+
+TEST(CApiTests, TestPositionSetup) {
+    auto engine = chessatron_new(1);
+    ASSERT_NE(engine, nullptr);
+    chessatron_move moves[256];
+    ASSERT_EQ(chessatron_legal_moves(engine, moves, 256), 20);
+    ASSERT_EQ(chessatron_perft(engine, 3), 8902);
+
+    ASSERT_EQ(chessatron_set_fen(engine, "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"), 0);
+    ASSERT_EQ(chessatron_perft(engine, 2), 2039);
+    // only as many moves as there is room for are written, but all of them are counted
+    ASSERT_EQ(chessatron_legal_moves(engine, moves, 4), 48);
+    ASSERT_EQ(chessatron_make_move(engine, "e1g1"), 0);
+    ASSERT_EQ(chessatron_make_move(engine, "e1g1"), -1);
+    ASSERT_EQ(chessatron_set_fen(engine, "not a fen"), -1);
+    chessatron_free(engine);
+}
+
+TEST(CApiTests, TestEvaluateIsFromSideToMove) {
+    auto engine = chessatron_new(1);
+    ASSERT_EQ(chessatron_set_fen(engine, "4k3/8/8/8/8/8/8/3QK3 w - - 0 1"), 0);
+    ASSERT_GT(chessatron_evaluate(engine), 0);
+    ASSERT_EQ(chessatron_set_fen(engine, "4k3/8/8/8/8/8/8/3QK3 b - - 0 1"), 0);
+    ASSERT_LT(chessatron_evaluate(engine), 0);
+    chessatron_free(engine);
+}
+
+TEST(CApiTests, TestSearch) {
+    auto engine = chessatron_new(1);
+    ASSERT_EQ(chessatron_set_fen(engine, "6k1/5ppp/8/8/8/8/5PPP/R5K1 w - - 0 1"), 0);
+    std::vector<std::string> info_lines;
+    const chessatron_limits limits = {0, 0, 4};
+    chessatron_result result;
+    ASSERT_EQ(chessatron_search(
+                  engine, &limits, [](const char* line, void* lines) { static_cast<std::vector<std::string>*>(lines)->push_back(line); },
+                  &info_lines, &result),
+              0);
+    ASSERT_EQ(std::string(result.bestmove), "a1a8");
+    ASSERT_EQ(result.mate, 1);
+    ASSERT_GT(result.nodes, 0);
+    ASSERT_FALSE(info_lines.empty());
+    ASSERT_EQ(info_lines[0].rfind("info depth 1", 0), 0);
+    chessatron_free(engine);
+}
+
+TEST(CApiTests, TestAsyncSearch) {
+    auto engine = chessatron_new(1);
+    std::atomic<int> done_calls = 0;
+    ASSERT_EQ(chessatron_search_async(engine, nullptr, nullptr, [](const chessatron_result*, void* calls) {
+                  *static_cast<std::atomic<int>*>(calls) += 1;
+              }, &done_calls),
+              0);
+    // an infinite search is still running, so another can't be started
+    const chessatron_limits limits = {0, 0, 1};
+    ASSERT_EQ(chessatron_search(engine, &limits, nullptr, nullptr, nullptr), -1);
+    chessatron_stop(engine);
+    ASSERT_EQ(done_calls, 1);
+
+    chessatron_result result;
+    ASSERT_EQ(chessatron_search(engine, &limits, nullptr, nullptr, &result), 0);
+    ASSERT_EQ(result.depth, 1);
+    chessatron_free(engine);
+}
@@ -0,0 +1,17 @@
+#include <gtest/gtest.h>
+
+#include "../src/chessboard.hpp"
+#include "../src/datagen.hpp"
+
+TEST(DatagenTests, TestPackedPositionRoundTrip) {
+    for (const auto fen : {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w Kq - 3 17",
+                           "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3", "8/8/8/8/1k2Pp2/8/8/K7 b - e3 0 60",
+                           "2r2k2/8/4P1R1/1p6/8/P4K1N/7b/2B5 b - - 99 255"}) {
+        Position pos;
+        pos.set_from_fen(fen);
+        const auto packed = Datagen::pack_position(pos, -123, 2);
+        ASSERT_EQ(Datagen::unpack_to_fen(packed), fen);
+        ASSERT_EQ(packed.score, -123);
+        ASSERT_EQ(packed.result, 2);
+    }
+}
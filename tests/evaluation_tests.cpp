@@ -0,0 +1,49 @@
+#include <gtest/gtest.h>
+
+#include "../src/chessboard.hpp"
+#include "../src/evaluation.hpp"
+#include "../src/magic_numbers/eval_terms.hpp"
+
+TEST(EvaluationTests, TestPawnStructureTerms) {
+    Position pos;
+    pos.set_from_fen("4k3/8/8/8/8/P7/P7/4K3 w - - 0 1");
+    // both pawns are isolated, the rear one is doubled, and only the front one counts as passed
+    ASSERT_EQ(Evaluation::evaluate_pawn_structure(pos), 2 * EvalTerms::IsolatedPawn + EvalTerms::DoubledPawn + EvalTerms::PassedPawn[2]);
+
+    pos.set_from_fen("4k3/8/8/3p4/3P4/4P3/8/4K3 w - - 0 1");
+    // e3 can't be defended and d5 stops it advancing, while the d5 pawn has no neighbours
+    ASSERT_EQ(Evaluation::evaluate_pawn_structure(pos), EvalTerms::BackwardPawn - EvalTerms::IsolatedPawn);
+
+    pos.set_from_fen("rnbqkbnr/pp3ppp/4p3/2pp4/3P4/4P3/PPP2PPP/RNBQKBNR w KQkq - 0 1");
+    ASSERT_EQ(Evaluation::evaluate_pawn_structure(pos), 0);
+}
+
+TEST(EvaluationTests, TestPawnTableMatchesUncached) {
+    PawnTable pawn_table;
+    Position pos;
+    for (const auto fen : {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+                           "8/8/1p2k1p1/3p3p/1p1P1P1P/1P2PK2/8/8 w - - 3 54"}) {
+        pos.set_from_fen(fen);
+        const auto uncached = Evaluation::evaluate_board(pos);
+        ASSERT_EQ(Evaluation::evaluate_board(pos, pawn_table), uncached);
+        ASSERT_EQ(Evaluation::evaluate_board(pos, pawn_table), uncached);
+    }
+    ASSERT_EQ(pawn_table.hits(), 3);
+    ASSERT_EQ(pawn_table.misses(), 3);
+}
+
+TEST(EvaluationTests, TestEvaluationIsSymmetric) {
+    // each pair is the same position with the board flipped and the colours swapped, so the side to move should see the same score
+    const std::array<std::pair<const char*, const char*>, 3> fen_pairs = {{
+        {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", "r3k2r/pppbbppp/2n2q1P/1P2p3/3pn3/BN2PNP1/P1PPQPB1/R3K2R b - - 0 1"},
+        {"2r2k2/8/4P1R1/1p6/8/P4K1N/7b/2B5 b - - 0 1", "2b5/7B/p4k1n/8/1P6/4p1r1/8/2R2K2 w - - 0 1"},
+        {"1rb1rn1k/p3q1bp/2p3p1/2p1p3/2P1P2N/PP1RQNP1/1B3P2/4R1K1 b - - 0 1", "4r1k1/1b3p2/pp1rqnp1/2p1p2n/2P1P3/2P3P1/P3Q1BP/1RB1RN1K w - - 0 1"},
+    }};
+    Position pos;
+    for (const auto& [fen, mirrored_fen] : fen_pairs) {
+        pos.set_from_fen(fen);
+        const auto score = Evaluation::evaluate_board(pos);
+        pos.set_from_fen(mirrored_fen);
+        ASSERT_EQ(Evaluation::evaluate_board(pos), score);
+    }
+}
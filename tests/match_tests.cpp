@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+#include <csignal>
+
+#include "../src/chessboard.hpp"
+#include "../src/match.hpp"
+#include "../src/uci_engine.hpp"
+
+TEST(MatchTests, TestStats) {
+    const Match::Stats even = {40, 20, 40};
+    ASSERT_DOUBLE_EQ(even.score(), 0.5);
+    ASSERT_NEAR(even.elo(), 0, 1e-9);
+    ASSERT_LT(even.llr(0, 5), 0);
+
+    const Match::Stats winning = {60, 20, 20};
+    ASSERT_DOUBLE_EQ(winning.score(), 0.7);
+    ASSERT_NEAR(winning.elo(), 147.19, 0.01);
+    ASSERT_GT(winning.elo_error(), 0);
+    ASSERT_GT(winning.llr(0, 5), 0);
+    // more games of the same score narrow the error bars and strengthen the evidence
+    const Match::Stats more_winning = {600, 200, 200};
+    ASSERT_LT(more_winning.elo_error(), winning.elo_error());
+    ASSERT_NEAR(more_winning.llr(0, 5), 10 * winning.llr(0, 5), 1e-9);
+}
+
+TEST(MatchTests, TestRandomOpeningIsLegal) {
+    std::mt19937_64 rng(42);
+    for (int i = 0; i < 20; i++) {
+        const auto opening = Match::random_opening(rng, 8);
+        Position pos;
+        pos.set_from_fen(opening.fen);
+        BoardHistory history(pos);
+        for (const auto& move_string : opening.moves) {
+            const auto move = history[history.len() - 1].generate_move_from_string(move_string);
+            ASSERT_TRUE(move.has_value());
+            history[history.len() - 1].make_move(*move, history);
+        }
+        ASSERT_EQ(history.len(), 9);
+    }
+}
+
+TEST(MatchTests, TestEnginesDontInheritOtherEnginesPipes) {
+    const auto path = (std::filesystem::temp_directory_path() / "chessatron_fd_test.sh").string();
+    {
+        // the listing is made by ls in place of the shell, so it shows exactly the descriptors the engine was started with
+        std::ofstream script(path);
+        script << "#!/bin/sh\nexec ls -l /proc/$$/fd\n";
+    }
+    std::filesystem::permissions(path, std::filesystem::perms::owner_all);
+
+    UciEngine first(path);
+    UciEngine second(path);
+    ASSERT_TRUE(second.is_running());
+    for (auto line = second.read_line(5000); line.has_value(); line = second.read_line(5000)) {
+        // lines look like "lr-x------ 1 user group 64 Oct 19 03:00 3 -> pipe:[123]"
+        const auto arrow = line->find(" -> ");
+        if (arrow == std::string::npos || (line->find("pipe:", arrow) == std::string::npos && line->find("socket:", arrow) == std::string::npos)) {
+            continue;
+        }
+        const auto fd = std::stoi(line->substr(line->rfind(' ', arrow - 1) + 1));
+        EXPECT_LE(fd, 2) << "the second engine inherited " << *line;
+    }
+    std::filesystem::remove(path);
+}
+
+TEST(MatchTests, TestWritingToExitedEngineDoesntRaiseSigpipe) {
+    // with the default SIGPIPE action, a raised signal would kill the test process
+    signal(SIGPIPE, SIG_DFL);
+    UciEngine engine("/bin/true");
+    ASSERT_EQ(engine.read_line(5000), std::nullopt);
+    for (int i = 0; i < 100; i++) {
+        engine.send("isready");
+    }
+    // and the engine leaves the signal's handling for the rest of the process alone
+    ASSERT_EQ(signal(SIGPIPE, SIG_DFL), SIG_DFL);
+}
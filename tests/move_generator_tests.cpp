@@ -58,6 +58,29 @@ TEST(MoveGeneratorTests, TestDoubleCheck) {
     ASSERT_EQ(king_moves.size(), moves.size());
 }
 
+TEST(MoveGeneratorTests, TestCheckEvasions) {
+    const std::array<std::pair<const char*, size_t>, 5> positions = {{
+        {"K6r/1PP1k3/4N3/8/8/8/8/8 w - - 0 1", 11},
+        {"K6r/1PP1kN2/4N3/8/8/8/8/8 w - - 0 1", 13},
+        {"7k/8/8/8/K6r/4P3/3P4/8 w - - 0 1", 6},
+        {"8/3p4/4p3/k6R/8/8/8/7K b - - 0 1", 6},
+        {"8/8/8/8/8/4K3/1pp1n3/k6R b - - 0 1", 11},
+    }};
+    Position pos;
+    for (const auto& [fen, count] : positions) {
+        pos.set_from_fen(fen);
+        ASSERT_TRUE(pos.in_check());
+        const auto all = MoveGenerator::generate_legal_moves<MoveGenType::ALL_LEGAL>(pos, pos.stm());
+        ASSERT_EQ(all.size(), count);
+        const auto noisy = MoveGenerator::generate_legal_moves<MoveGenType::NOISY>(pos, pos.stm());
+        const auto quiet = MoveGenerator::generate_legal_moves<MoveGenType::QUIETS>(pos, pos.stm());
+        ASSERT_EQ(noisy.size() + quiet.size(), count);
+        for (size_t i = 0; i < all.size(); i++) {
+            ASSERT_TRUE(MoveGenerator::is_move_legal(pos, all[i].move));
+        }
+    }
+}
+
 TEST(MoveGeneratorTests, TestPawnPromotions) {
     Position pos;
     MoveList m;
@@ -312,4 +335,47 @@ TEST(MoveGeneratorTests, TestThreatenedCastle) {
     MoveList moves;
     MoveGenerator::generate_castling_moves(pos, pos.stm(), moves);
     ASSERT_EQ(moves.size(), 0);
-}
\ No newline at end of file
+}
+TEST(MoveGeneratorTests, TestSliderAttacksMatchRays) {
+    uint64_t occupancy = 0x9E3779B97F4A7C15ULL;
+    for (int i = 0; i < 256; i++) {
+        occupancy ^= occupancy << 13;
+        occupancy ^= occupancy >> 7;
+        occupancy ^= occupancy << 17;
+        for (Square sq = Square::A1; sq != Square::NONE; sq++) {
+            ASSERT_EQ(MoveGenerator::generate_rook_mm(occupancy, sq), generate_rook_attacks(sq, occupancy));
+            ASSERT_EQ(MoveGenerator::generate_bishop_mm(occupancy, sq), generate_bishop_attacks(sq, occupancy));
+        }
+    }
+}
+
+TEST(MoveGeneratorTests, TestHasLegalMove) {
+    Position pos;
+    pos.set_from_fen("7k/5Q2/6K1/8/8/8/8/8 b - - 0 1");
+    ASSERT_FALSE(MoveGenerator::has_legal_move(pos));
+    pos.set_from_fen("7k/6Q1/6K1/8/8/8/8/8 b - - 0 1");
+    ASSERT_FALSE(MoveGenerator::has_legal_move(pos));
+    // the only moves are by the pawn
+    pos.set_from_fen("7k/5Q2/6K1/8/8/8/p7/8 b - - 0 1");
+    ASSERT_TRUE(MoveGenerator::has_legal_move(pos));
+    // the bishop is pinned and can't move along the pin
+    pos.set_from_fen("k7/b2N4/1K6/8/8/8/8/R7 b - - 0 1");
+    ASSERT_FALSE(MoveGenerator::has_legal_move(pos));
+
+    // random games from kiwipete, checking every position against full move generation
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    for (int game = 0; game < 50; game++) {
+        pos.set_from_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+        for (int ply = 0; ply < 200; ply++) {
+            const auto moves = MoveGenerator::generate_legal_moves<MoveGenType::ALL_LEGAL>(pos, pos.stm());
+            ASSERT_EQ(MoveGenerator::has_legal_move(pos), moves.size() > 0);
+            if (moves.size() == 0) {
+                break;
+            }
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            pos = Position(pos, moves[state % moves.size()].move);
+        }
+    }
+}
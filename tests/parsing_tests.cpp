@@ -2,9 +2,7 @@
 
 #include "../src/chessboard.hpp"
 #include "../src/search.hpp"
-
-std::vector<std::string> split_on_whitespace(const std::string& data);
-void process_position_command(const std::string& line, SearchHandler& s);
+#include "../src/uci.hpp"
 
 TEST(ParsingTests, TestSetString) {
     Position pos;
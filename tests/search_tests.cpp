@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+#include <numeric>
+
+#include "../src/chessboard.hpp"
+#include "../src/move_generator.hpp"
+#include "../src/search.hpp"
+
+TEST(SearchTests, TestSeeValueMatchesThreshold) {
+    const std::array<const char*, 4> fens = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+        "1k1r3r/pp3pp1/2p1pn1p/8/3Pq3/2Q3P1/PP3PBP/R4RK1 w - - 0 1",
+    };
+    Position pos;
+    for (const auto fen : fens) {
+        pos.set_from_fen(fen);
+        const auto root_moves = MoveGenerator::generate_legal_moves<MoveGenType::ALL_LEGAL>(pos, pos.stm());
+        for (size_t i = 0; i < root_moves.size(); i++) {
+            const Position child(pos, root_moves[i].move);
+            const auto moves = MoveGenerator::generate_legal_moves<MoveGenType::ALL_LEGAL>(child, child.stm());
+            for (size_t j = 0; j < moves.size(); j++) {
+                // the threshold test is monotonic, so checking either side of the exact value is enough
+                const auto value = Search::static_exchange_value(child, moves[j].move);
+                ASSERT_TRUE(Search::static_exchange_evaluation(child, moves[j].move, value));
+                ASSERT_FALSE(Search::static_exchange_evaluation(child, moves[j].move, value + 1));
+            }
+        }
+    }
+}
+
+TEST(SearchTests, TestNodeLimitedSearch) {
+    TranspositionTable table;
+    SearchHandler handler(table);
+    handler.set_print_info(false);
+    Position pos;
+    pos.set_from_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    handler.set_pos(pos);
+    const auto [move, score] = handler.search_sync(NodeTC{2000, 4000});
+    // the hard limit is only checked between moves, so allow a single quiescence search of overshoot
+    ASSERT_LE(handler.get_node_count(), 4500);
+    const auto moves = MoveGenerator::generate_legal_moves<MoveGenType::ALL_LEGAL>(pos, pos.stm());
+    ASSERT_TRUE(std::any_of(moves.begin(), moves.end(), [&](const ScoredMove& legal) { return legal.move == move; }));
+    (void) score;
+}
+
+TEST(SearchTests, TestInfoIsThrottled) {
+    TranspositionTable table;
+    SearchHandler handler(table);
+    std::vector<std::string> lines;
+    handler.set_info_callback([&lines](const std::string& line) { lines.push_back(line); });
+    Position pos;
+    pos.set_from_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    handler.set_pos(pos);
+
+    // every depth finishes within the interval, so only the first and last are sent
+    handler.set_info_interval(60000);
+    handler.search_sync(DepthTC{6});
+    ASSERT_EQ(lines.size(), 2);
+    ASSERT_EQ(lines[0].rfind("info depth 1 ", 0), 0);
+    ASSERT_EQ(lines[1].rfind("info depth 6 ", 0), 0);
+
+    // with no interval every depth is sent, along with a progress line whenever the node counter comes round
+    lines.clear();
+    handler.reset();
+    handler.set_pos(pos);
+    handler.set_info_interval(0);
+    handler.search_sync(DepthTC{8});
+    ASSERT_EQ(std::count_if(lines.begin(), lines.end(), [](const std::string& line) { return line.find(" pv ") != std::string::npos; }), 8);
+    const auto progress = std::find_if(lines.begin(), lines.end(), [](const std::string& line) { return line.find(" currmove ") != std::string::npos; });
+    ASSERT_NE(progress, lines.end());
+    ASSERT_NE(progress->find(" currmovenumber "), std::string::npos);
+    ASSERT_NE(progress->find(" hashfull "), std::string::npos);
+}
+
+TEST(SearchTests, TestParseBenchArgs) {
+    const auto defaults = parse_bench_args({});
+    ASSERT_TRUE(defaults.has_value());
+    ASSERT_EQ(defaults->depth, 14);
+    ASSERT_EQ(defaults->threads, 0);
+
+    const auto json = parse_bench_args({"10", "--json", "--repeat", "3"});
+    ASSERT_TRUE(json.has_value());
+    ASSERT_EQ(json->depth, 10);
+    ASSERT_TRUE(json->json);
+    ASSERT_EQ(json->repetitions, 3);
+
+    const auto smp = parse_bench_args({"12", "4", "64"});
+    ASSERT_TRUE(smp.has_value());
+    ASSERT_EQ(smp->depth, 12);
+    ASSERT_EQ(smp->threads, 4);
+    ASSERT_EQ(smp->hash_mb, 64);
+
+    for (const auto& args : std::vector<std::vector<std::string>>{
+             {"x"}, {"0"}, {"12", "0"}, {"12", "two"}, {"12", "2", "0"}, {"12", "2", "16", "extra"}, {"--repeat", "0"}, {"--threads"}}) {
+        ASSERT_FALSE(parse_bench_args(args).has_value());
+    }
+}
+
+TEST(SearchTests, TestSmpBenchNodeTotals) {
+    const auto summary = SearchHandler::run_smp_bench(3, 2, 1);
+    ASSERT_EQ(summary.thread_nodes.size(), 2);
+    ASSERT_EQ(std::accumulate(summary.thread_nodes.begin(), summary.thread_nodes.end(), (uint64_t) 0), summary.total_nodes);
+    ASSERT_EQ(std::accumulate(summary.position_nodes.begin(), summary.position_nodes.end(), (uint64_t) 0), summary.total_nodes);
+    ASSERT_GT(summary.thread_nodes[0], 0);
+}
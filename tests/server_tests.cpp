@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "../src/server.hpp"
+
+/**
+ * @brief A client connected to the server's socket, which reads the server's output a line at a time
+ */
+class ServerClient {
+    private:
+        int fd;
+        std::string buffer;
+
+    public:
+        explicit ServerClient(const std::string& path) {
+            fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            sockaddr_un address = {};
+            address.sun_family = AF_UNIX;
+            path.copy(address.sun_path, sizeof(address.sun_path) - 1);
+            connected = connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+        }
+        ~ServerClient() { close(fd); }
+
+        bool connected;
+
+        void send_line(const std::string& line) {
+            const auto data = line + "\n";
+            send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+        }
+
+        // the first line starting with prefix, or an empty string if there wasn't one within the timeout
+        std::string wait_for(const std::string& prefix, int timeout_ms) {
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+            while (true) {
+                for (auto end = buffer.find('\n'); end != std::string::npos; end = buffer.find('\n')) {
+                    const auto line = buffer.substr(0, end);
+                    buffer.erase(0, end + 1);
+                    if (line.rfind(prefix, 0) == 0) {
+                        return line;
+                    }
+                }
+                const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+                pollfd p = {fd, POLLIN, 0};
+                char data[4096];
+                if (remaining <= 0 || poll(&p, 1, remaining) <= 0) {
+                    return "";
+                }
+                const auto received = recv(fd, data, sizeof(data), 0);
+                if (received <= 0) {
+                    return "";
+                }
+                buffer.append(data, received);
+            }
+        }
+};
+
+std::string test_socket_path() { return "/tmp/chessatron_server_test_" + std::to_string(getpid()) + ".sock"; }
+
+TEST(ServerTests, TestConcurrentSessions) {
+    Server::UciServer server({test_socket_path(), 2, 16, 10});
+    ASSERT_TRUE(server.start());
+    ServerClient first(test_socket_path()), second(test_socket_path());
+    ASSERT_TRUE(first.connected);
+    ASSERT_TRUE(second.connected);
+
+    first.send_line("uci");
+    ASSERT_EQ(first.wait_for("uciok", 5000), "uciok");
+    // each session keeps its own position, though they share the workers and the table
+    first.send_line("position fen 6k1/5ppp/8/8/8/8/5PPP/R5K1 w - - 0 1");
+    second.send_line("position startpos moves e2e4 e7e5 d1h5 b8c6 f1c4 g8f6");
+    first.send_line("go depth 4");
+    second.send_line("go depth 4");
+    ASSERT_EQ(first.wait_for("bestmove", 10000), "bestmove a1a8");
+    ASSERT_EQ(second.wait_for("bestmove", 10000), "bestmove h5f7");
+    second.send_line("isready");
+    ASSERT_EQ(second.wait_for("readyok", 5000), "readyok");
+    server.stop();
+}
+
+TEST(ServerTests, TestStopInfiniteSearch) {
+    // one worker, so the second session's search waits in the queue behind the first
+    Server::UciServer server({test_socket_path(), 1, 16, 10});
+    ASSERT_TRUE(server.start());
+    ServerClient first(test_socket_path()), second(test_socket_path());
+    first.send_line("go infinite");
+    ASSERT_NE(first.wait_for("info depth 1", 5000), "");
+    second.send_line("go infinite");
+    second.send_line("stop");
+    ASSERT_NE(second.wait_for("bestmove", 1000), "");
+    first.send_line("stop");
+    ASSERT_NE(first.wait_for("bestmove", 1000), "");
+    // stopping the server ends any search still running
+    first.send_line("go infinite");
+    ASSERT_NE(first.wait_for("info depth 1", 5000), "");
+    server.stop();
+}
+
+TEST(ServerTests, TestMalformedCommands) {
+    Server::UciServer server({test_socket_path(), 1, 16, 10});
+    ASSERT_TRUE(server.start());
+    ServerClient bad(test_socket_path()), good(test_socket_path());
+    for (const auto& line : {"position fen", "position fen 8/8/8/8/8/8/8/8 w - - 0 1", "position fen 4k3/8/8/8/8/8/8/4K3 w - - x y",
+                             "position startpos moves e2e5", "position startpos e2e4"}) {
+        bad.send_line(line);
+        ASSERT_EQ(bad.wait_for("info string error", 5000), "info string error: invalid position command");
+    }
+    // a go the server can't run still gets a legal bestmove, from the last good position
+    bad.send_line("position startpos moves e2e4");
+    bad.send_line("go wtime abc");
+    ASSERT_EQ(bad.wait_for("info string error", 5000), "info string error: invalid go command");
+    const auto bestmove = bad.wait_for("bestmove", 5000);
+    ASSERT_NE(bestmove, "");
+    ASSERT_NE(bestmove, "bestmove 0000");
+    bad.send_line("go movestogo 0 wtime 100 btime 100");
+    ASSERT_NE(bad.wait_for("bestmove", 5000), "");
+
+    good.send_line("go depth 3");
+    ASSERT_NE(good.wait_for("bestmove", 5000), "");
+    bad.send_line("isready");
+    ASSERT_EQ(bad.wait_for("readyok", 5000), "readyok");
+    server.stop();
+}
@@ -0,0 +1,32 @@
+#include <gtest/gtest.h>
+
+#include "../src/spsa.hpp"
+
+TEST(SpsaTests, TestParseParameter) {
+    const auto param = Spsa::parse_parameter("lmr_table_divisor, float, 2.1816, 1, 3, 0.1, 0.002");
+    ASSERT_TRUE(param.has_value());
+    ASSERT_EQ(param->name, "lmr_table_divisor");
+    ASSERT_TRUE(param->is_float);
+    ASSERT_DOUBLE_EQ(param->value, 2.1816);
+    ASSERT_DOUBLE_EQ(param->max, 3);
+    ASSERT_EQ(param->uci_value(2.5), "2.500000");
+
+    const auto int_param = Spsa::parse_parameter("tt_depth_offset, int, 5, 3, 6, 0.15, 0.0006");
+    ASSERT_TRUE(int_param.has_value());
+    ASSERT_FALSE(int_param->is_float);
+    ASSERT_EQ(int_param->uci_value(4.6), "5");
+
+    ASSERT_FALSE(Spsa::parse_parameter("id name Chessatron").has_value());
+    ASSERT_FALSE(Spsa::parse_parameter("a, string, 1, 2, 3, 4, 5").has_value());
+}
+
+TEST(SpsaTests, TestGainsEndAtStepAndLearningRate) {
+    const Spsa::Parameter param = {"x", false, 50, 0, 100, 5, 0.002};
+    constexpr int iterations = 1000;
+    ASSERT_NEAR(Spsa::perturbation_size(param, iterations - 1, iterations), param.step, 1e-9);
+    ASSERT_NEAR(Spsa::learning_rate(param, iterations - 1, iterations), param.learning_rate, 1e-9);
+    // both gains only ever shrink
+    ASSERT_GT(Spsa::perturbation_size(param, 0, iterations), Spsa::perturbation_size(param, 500, iterations));
+    ASSERT_GT(Spsa::learning_rate(param, 0, iterations) * Spsa::perturbation_size(param, 0, iterations),
+              Spsa::learning_rate(param, 500, iterations) * Spsa::perturbation_size(param, 500, iterations));
+}
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+
+#include "../src/chessboard.hpp"
+#include "../src/evaluation.hpp"
+#include "../src/tuner.hpp"
+
+TEST(TunerTests, TestParseResult) {
+    ASSERT_EQ(Tuner::parse_result("8/8/8/8/8/8/8/K6k w - - 0 1 [1.0]"), 1.0);
+    ASSERT_EQ(Tuner::parse_result("8/8/8/8/8/8/8/K6k w - - c9 \"1/2-1/2\";"), 0.5);
+    ASSERT_EQ(Tuner::parse_result("8/8/8/8/8/8/8/K6k w - - c9 \"0-1\";"), 0.0);
+    ASSERT_EQ(Tuner::parse_result("8/8/8/8/8/8/8/K6k w - - 0 1 | 35 | 0.5"), 0.5);
+    ASSERT_FALSE(Tuner::parse_result("8/8/8/8/8/8/8/K6k w - - 0 1").has_value());
+    // malformed results are skipped rather than thrown on
+    ASSERT_FALSE(Tuner::parse_result("8/8/8/8/8/8/8/K6k w - - 0 1 [draw]").has_value());
+    ASSERT_FALSE(Tuner::parse_result("8/8/8/8/8/8/8/K6k w - - 0 1 [").has_value());
+    ASSERT_FALSE(Tuner::parse_result("8/8/8/8/8/8/8/K6k w - - 0 1 | 35 |").has_value());
+    ASSERT_FALSE(Tuner::parse_result("8/8/8/8/8/8/8/K6k w - - 0 1 [2.0]").has_value());
+}
+
+TEST(TunerTests, TestParseArgs) {
+    const auto defaults = Tuner::parse_args({});
+    ASSERT_TRUE(defaults.has_value());
+    ASSERT_EQ(defaults->epochs, 1000);
+    ASSERT_TRUE(defaults->tune_psqt);
+    ASSERT_EQ(defaults->regularization, 0);
+
+    const auto settings = Tuner::parse_args({"500", "--terms-only", "2", "psqt.hpp", "terms.hpp", "--regularization", "1e-9"});
+    ASSERT_TRUE(settings.has_value());
+    ASSERT_EQ(settings->epochs, 500);
+    ASSERT_EQ(settings->threads, 2);
+    ASSERT_EQ(settings->psqt_path, "psqt.hpp");
+    ASSERT_EQ(settings->terms_path, "terms.hpp");
+    ASSERT_FALSE(settings->tune_psqt);
+    ASSERT_EQ(settings->regularization, 1e-9);
+
+    ASSERT_FALSE(Tuner::parse_args({"x"}).has_value());
+    ASSERT_FALSE(Tuner::parse_args({"0"}).has_value());
+    ASSERT_FALSE(Tuner::parse_args({"--regularization", "-1"}).has_value());
+    ASSERT_FALSE(Tuner::parse_args({"--regularization"}).has_value());
+    ASSERT_FALSE(Tuner::parse_args({"--psqt-only"}).has_value());
+    ASSERT_FALSE(Tuner::parse_args({"1", "1", "a", "b", "c"}).has_value());
+}
+
+TEST(TunerTests, TestLinearEvalMatchesEvaluation) {
+    const auto params = Tuner::initial_parameters();
+    Position pos;
+    for (const auto fen : {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", "2r2k2/8/4P1R1/1p6/8/P4K1N/7b/2B5 b - - 0 1",
+                           "1rb1rn1k/p3q1bp/2p3p1/2p1p3/2P1P2N/PP1RQNP1/1B3P2/4R1K1 b - - 0 1"}) {
+        pos.set_from_fen(fen);
+        Tuner::TuningData data;
+        data.add_position(pos, 0.5);
+        const auto eval = Evaluation::evaluate_board(pos);
+        const auto white_eval = (pos.stm() == Side::WHITE) ? eval : -eval;
+        // the engine rounds the tapered score towards zero, the tuner doesn't round at all
+        ASSERT_NEAR(Tuner::linear_eval(data.entries[0], data.features.data(), params), white_eval, 1.0);
+    }
+}
+
+TEST(TunerTests, TestFeatureCacheRoundTrip) {
+    const auto path = (std::filesystem::temp_directory_path() / "chessatron_tuner_test.epd").string();
+    std::filesystem::remove(path + ".features");
+    {
+        std::ofstream file(path);
+        file << "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - c9 \"1-0\";\n";
+        file << "not a position\n";
+        file << "8/8/8/8/8/8/8/K6k w - - 0 1 [abc]\n";
+        file << "2r2k2/8/4P1R1/1p6/8/P4K1N/7b/2B5 b - - 0 1 [0.5]\n";
+    }
+    const auto parsed = Tuner::load_data(path);
+    ASSERT_TRUE(std::filesystem::exists(path + ".features"));
+    const auto cached = Tuner::load_data(path);
+    ASSERT_EQ(parsed.entries.size(), 2);
+    ASSERT_EQ(cached.entries.size(), 2);
+    ASSERT_EQ(parsed.features, cached.features);
+    ASSERT_EQ(cached.entries[0].result, 2);
+    ASSERT_EQ(cached.entries[1].result, 1);
+
+    // a cache written with a different feature layout is rebuilt, even though it's newer than the positions
+    {
+        std::fstream cache(path + ".features", std::ios::binary | std::ios::in | std::ios::out);
+        cache.seekp(8);
+        cache.put('\xff');
+    }
+    const auto rebuilt = Tuner::load_data(path);
+    ASSERT_EQ(rebuilt.features, parsed.features);
+    ASSERT_EQ(Tuner::load_data(path).features, parsed.features);
+    std::filesystem::remove(path);
+    std::filesystem::remove(path + ".features");
+}
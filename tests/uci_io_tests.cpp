@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include <poll.h>
+#include <unistd.h>
+
+#include "../src/search.hpp"
+#include "../src/uci_io.hpp"
+
+// whatever arrives on fd within timeout_ms, in a single read
+std::string read_available(int fd, int timeout_ms) {
+    pollfd p = {fd, POLLIN, 0};
+    char buffer[4096];
+    if (poll(&p, 1, timeout_ms) <= 0) {
+        return "";
+    }
+    const auto received = read(fd, buffer, sizeof(buffer));
+    return (received > 0) ? std::string(buffer, received) : "";
+}
+
+TEST(UciIoTests, TestOutputIsBufferedUntilFlushed) {
+    int pipe_fds[2];
+    ASSERT_EQ(pipe(pipe_fds), 0);
+    {
+        UciOutput output(pipe_fds[1], 60000);
+        // nothing has been sent yet, so the first line goes out at once and the next waits for a flush
+        output.write_line("info depth 1");
+        output.write_line("info depth 2");
+        ASSERT_EQ(read_available(pipe_fds[0], 10), "info depth 1\n");
+        output.send("bestmove e2e4");
+        ASSERT_EQ(read_available(pipe_fds[0], 10), "info depth 2\nbestmove e2e4\n");
+    }
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+}
+
+TEST(UciIoTests, TestInputSplitsLines) {
+    int pipe_fds[2];
+    ASSERT_EQ(pipe(pipe_fds), 0);
+    UciOutput output(-1);
+    int stops = 0;
+    {
+        UciInput input(pipe_fds[0], output, [&stops] { stops += 1; });
+        const std::string commands = "isready\r\nstop\nposition startpos";
+        ASSERT_EQ(write(pipe_fds[1], commands.data(), commands.size()), static_cast<ssize_t>(commands.size()));
+        close(pipe_fds[1]);
+        ASSERT_EQ(input.next_line(), "isready");
+        ASSERT_EQ(input.next_line(), "stop");
+        ASSERT_EQ(input.next_line(), "position startpos");
+        ASSERT_EQ(input.next_line(), std::nullopt);
+    }
+    ASSERT_EQ(stops, 1);
+    close(pipe_fds[0]);
+}
+
+TEST(UciIoTests, TestStopToBestmoveLatency) {
+    int input_fds[2], output_fds[2];
+    ASSERT_EQ(pipe(input_fds), 0);
+    ASSERT_EQ(pipe(output_fds), 0);
+    UciOutput output(output_fds[1]);
+    SearchHandler handler;
+    handler.set_output(output);
+    {
+        // the main thread never reads the commands here, as if it were busy, so only the input thread's stop can end the search
+        UciInput input(input_fds[0], output, [&handler] { handler.EndSearch(); });
+        Position pos;
+        pos.set_from_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+        handler.set_pos(pos);
+        handler.search(InfiniteTC{});
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        while (!read_available(output_fds[0], 0).empty()) {
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        ASSERT_EQ(write(input_fds[1], "stop\n", 5), 5);
+        std::string received;
+        while (received.find("bestmove") == std::string::npos) {
+            const auto data = read_available(output_fds[0], 1000);
+            ASSERT_FALSE(data.empty());
+            received += data;
+        }
+        const auto latency_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        RecordProperty("stop_to_bestmove_us", std::to_string(latency_us));
+        std::cout << "stop to bestmove: " << latency_us << " us" << std::endl;
+        // generous, as the machine running the tests may be loaded, but far below the time a search takes to reach any depth
+        ASSERT_LT(latency_us, 100000);
+    }
+    close(input_fds[0]);
+    close(input_fds[1]);
+    close(output_fds[0]);
+    close(output_fds[1]);
+}